@@ -0,0 +1,192 @@
+#include "wordle_solver.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <tbb/global_control.h>
+
+// Keeps results alive so that the compiler cannot optimize the benchmarked code away.
+volatile std::size_t sink = 0;
+
+// Runs fn "repetitions" times and returns the fastest run in milliseconds, which is the least noisy estimate.
+template <typename Fn>
+double time_ms(std::size_t const repetitions, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        auto const st = std::chrono::high_resolution_clock::now();
+        std::invoke(fn);
+        auto const ct = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(ct - st).count());
+    }
+
+    return best;
+}
+
+void report(std::string const& name, double const ms) {
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << ms << " ms\n";
+}
+
+int main(int const argc, char const* const* const argv) {
+    if (argc < 3 || argc > 4) {
+        std::cout << "Usage: ./wordle_benchmark guess_list.txt word_list.txt [repetitions = 5]\n";
+        return 0;
+    }
+
+    std::vector<Word> const guesses = load_word_list(argv[1]);
+    std::vector<Word> const words = load_word_list(argv[2]);
+    std::size_t const repetitions = argc == 4 ? std::max(std::atoi(argv[3]), 1) : 5;
+
+    report("feedback_code (all pairs)", time_ms(repetitions, [&] {
+               std::size_t sum = 0;
+
+               for (Word const& guess : guesses) {
+                   for (Word const& truth : words) {
+                       sum += feedback_code(guess, truth);
+                   }
+               }
+
+               sink = sink + sum;
+           }));
+
+    report("PatternMatrix (all pairs)", time_ms(repetitions, [&] {
+               PatternMatrix const matrix{guesses, words};
+               sink = sink + matrix.row(0)[0];
+           }));
+
+    for (Scoring const scoring :
+         {Scoring::entropy, Scoring::fixed_entropy, Scoring::adversarial, Scoring::expected_guesses}) {
+        report("best_choice " + std::string{scoring_names[static_cast<std::size_t>(scoring)].first} + " (root)",
+               time_ms(repetitions, [&] { sink = sink + best_choice(guesses, words, {}, scoring).first[0]; }));
+    }
+
+    PatternMatrix const matrix{guesses, words};
+
+    // Histograms of all rows of the pattern matrix, i.e. just the bucket counting of best_choice at the root.
+    auto const histogram_kernel = [&](std::string const& name, auto&& kernel) {
+        report("histogram " + name + " (all rows)", time_ms(repetitions, [&] {
+                   std::size_t sum = 0;
+
+                   for (std::size_t g = 0; g < guesses.size(); ++g) {
+                       Histogram h{0};
+                       kernel(matrix.row(g), h);
+                       sum += h[g % num_feedbacks];
+                   }
+
+                   sink = sink + sum;
+               }));
+    };
+
+    histogram_kernel("scalar", add_codes_scalar);
+    histogram_kernel("interleaved", add_codes_interleaved);
+#if defined(WORDLE_SOLVER_X86)
+    if (has_avx512()) {
+        histogram_kernel("avx512", add_codes_avx512);
+    }
+#endif
+    histogram_kernel("add_codes", add_codes);
+
+    // Filtering the guess list as in hard mode, for the information from every 64th word as the opener's truth.
+    std::vector<WordInfo> infos;
+
+    for (std::size_t w = 0; w < words.size(); w += 64) {
+        infos.emplace_back(parse_word("soare"), words[w]);
+    }
+
+    report("filter check_word (guess list)", time_ms(repetitions, [&] {
+               std::size_t sum = 0;
+
+               for (WordInfo const& info : infos) {
+                   sum += std::ranges::count_if(guesses, [&](Word const w) { return info.check_word(w); });
+               }
+
+               sink = sink + sum;
+           }));
+
+    PackedWords const packed_guesses{guesses};
+
+    auto const filter_kernel = [&](std::string const& name, auto&& kernel) {
+        report("filter " + name + " (guess list)", time_ms(repetitions, [&] {
+                   std::size_t sum = 0;
+
+                   for (WordInfo const& info : infos) {
+                       sum += kernel(packed_guesses, info)[0];
+                   }
+
+                   sink = sink + sum;
+               }));
+    };
+
+    filter_kernel("scalar", filter_mask_scalar);
+#if defined(WORDLE_SOLVER_X86)
+    if (has_avx2()) {
+        filter_kernel("avx2", filter_mask_avx2);
+    }
+#endif
+
+    report("filter_words (guess list)", time_ms(repetitions, [&] {
+               std::size_t sum = 0;
+
+               for (WordInfo const& info : infos) {
+                   sum += filter_words(guesses, info).size();
+               }
+
+               sink = sink + sum;
+           }));
+
+    report("combined_histogram (3 guesses)", time_ms(repetitions, [&] {
+               std::vector<std::span<Feedback const>> const rows{matrix.row(0), matrix.row(1), matrix.row(2)};
+               sink = sink + combined_histogram(combined_codes(rows), rows.size()).size();
+           }));
+
+    report("beam_search (2 guesses, width 4)",
+           time_ms(1, [&] { sink = sink + beam_search(guesses, words, 2, 4, Scoring::entropy).size(); }));
+
+    // Scaling of the lookahead search with the number of threads, on the words left after the most common response to
+    // a good opener. Counts beyond the number of cores show the cost of oversubscription.
+    std::array<std::vector<Word>, num_feedbacks> after_opener;
+
+    for (Word const& w : words) {
+        after_opener[feedback_code(parse_word("soare"), w)].push_back(w);
+    }
+
+    std::vector<Word> const& lookahead_words = *std::ranges::max_element(after_opener, {}, &std::vector<Word>::size);
+    CostModel const model;
+
+    report("best_choice_lookahead (serial)", time_ms(1, [&] {
+               TranspositionTable table{default_table_bytes};
+               sink = sink + best_choice_lookahead(guesses, lookahead_words, model, false, 3, 4, table,
+                                                   std::numeric_limits<std::size_t>::max())
+                                 .first[0];
+           }));
+
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        tbb::global_control const limit{tbb::global_control::max_allowed_parallelism, threads};
+        report("best_choice_lookahead (" + std::to_string(threads) + " threads)", time_ms(1, [&] {
+                   TranspositionTable table{default_table_bytes};
+                   sink = sink + best_choice_lookahead(guesses, lookahead_words, model, false, 3, 4, table).first[0];
+               }));
+    }
+
+    std::vector<Word> secrets;
+
+    for (std::size_t i = 0; i < words.size(); i += words.size() / 20) {
+        secrets.push_back(words[i]);
+    }
+
+    report("simulate_games (20 games)", time_ms(1, [&] {
+               sink = sink + simulate_games(guesses, words, secrets, {}, false, Scoring::entropy, 6).total_guesses;
+           }));
+
+    Dictionary const dict{guesses, words};
+
+    report("MultiGame::suggest (4 boards)", time_ms(repetitions, [&] {
+               MultiGame const game{dict, 4};
+               sink = sink + game.suggest().first[0];
+           }));
+}
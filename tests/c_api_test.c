@@ -0,0 +1,178 @@
+/* Tests of the C interface, written in C so that the header is checked to be usable from C as well. Plays full games
+ * through the library and checks that every misuse is reported through the error codes and wordle_solver_last_error. */
+#include "wordle_solver_c.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                                  \
+    do {                                                                                             \
+        if (!(cond) && failures++ < 20) {                                                            \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                \
+        }                                                                                            \
+    } while (0)
+
+/* Response code of "guess" for the secret "truth", computed independently of the library. */
+static uint8_t feedback_code(char const* guess, char const* truth) {
+    static uint8_t const digits[5] = {1, 3, 9, 27, 81};
+    int unmatched[26] = {0};
+    uint8_t code = 0;
+
+    for (int i = 0; i < 5; ++i) {
+        if (guess[i] == truth[i]) {
+            code += 2 * digits[i];
+        } else {
+            ++unmatched[truth[i] - 'a'];
+        }
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        if (guess[i] != truth[i] && unmatched[guess[i] - 'a'] > 0) {
+            --unmatched[guess[i] - 'a'];
+            code += digits[i];
+        }
+    }
+
+    return code;
+}
+
+static int is_candidate(wordle_solver const* solver, size_t board, size_t word) {
+    uint64_t const* blocks = NULL;
+    size_t num_blocks = 0;
+    CHECK(wordle_solver_candidates(solver, board, &blocks, &num_blocks) == 0);
+    return word / 64 < num_blocks && ((blocks[word / 64] >> (word % 64)) & 1);
+}
+
+static size_t num_candidates(wordle_solver const* solver, size_t board) {
+    uint64_t const* blocks = NULL;
+    size_t num_blocks = 0;
+    size_t result = 0;
+    CHECK(wordle_solver_candidates(solver, board, &blocks, &num_blocks) == 0);
+
+    for (size_t i = 0; i < num_blocks; ++i) {
+        result += (size_t)__builtin_popcountll(blocks[i]);
+    }
+
+    return result;
+}
+
+/* Plays a game against the secret word with the given index and returns the number of guesses. */
+static size_t play(char const* guess_list, char const* word_list, size_t secret) {
+    wordle_solver* solver = wordle_solver_create(guess_list, word_list, 1);
+    CHECK(solver != NULL);
+
+    if (solver == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    char const* words = wordle_solver_words(solver, &count);
+    char truth[6] = {0};
+    memcpy(truth, words + 5 * secret, 5);
+    CHECK(num_candidates(solver, 0) == count);
+
+    size_t turns = 0;
+
+    while (wordle_solver_solved(solver, 0) == 0 && turns < 10) {
+        char guess[6];
+        double score = 0.0;
+        CHECK(wordle_solver_suggest(solver, guess, &score) == 0);
+        CHECK(strlen(guess) == 5 && strspn(guess, "abcdefghijklmnopqrstuvwxyz") == 5);
+
+        size_t const before = num_candidates(solver, 0);
+        uint8_t const code = feedback_code(guess, truth);
+        CHECK(wordle_solver_apply_feedback(solver, guess, &code) == 0);
+        CHECK(wordle_solver_last_error()[0] == '\0');
+        CHECK(is_candidate(solver, 0, secret));
+        CHECK(num_candidates(solver, 0) <= before);
+        ++turns;
+    }
+
+    CHECK(wordle_solver_solved(solver, 0) == 1);
+    wordle_solver_free(solver);
+    return turns;
+}
+
+static void test_errors(char const* guess_list, char const* word_list) {
+    CHECK(wordle_solver_abi_version() == WORDLE_SOLVER_ABI_VERSION);
+
+    CHECK(wordle_solver_create(NULL, word_list, 1) == NULL);
+    CHECK(strstr(wordle_solver_last_error(), "wordle_solver_create") != NULL);
+    CHECK(wordle_solver_create(guess_list, "/nonexistent/words.txt", 1) == NULL);
+    CHECK(strcmp(wordle_solver_last_error(), "Could not load word lists!") == 0);
+
+    /* NULL handles */
+    char guess[6];
+    uint8_t code = 0;
+    size_t count = 1;
+    uint64_t const* blocks = NULL;
+    size_t num_blocks = 0;
+    CHECK(wordle_solver_suggest(NULL, guess, NULL) < 0);
+    CHECK(strstr(wordle_solver_last_error(), "wordle_solver_suggest") != NULL);
+    CHECK(wordle_solver_apply_feedback(NULL, "soare", &code) < 0);
+    CHECK(wordle_solver_load_data(NULL, "data.bin") < 0);
+    CHECK(wordle_solver_solved(NULL, 0) < 0);
+    CHECK(strstr(wordle_solver_last_error(), "wordle_solver_solved") != NULL);
+    CHECK(wordle_solver_candidates(NULL, 0, &blocks, &num_blocks) < 0);
+    CHECK(wordle_solver_words(NULL, &count) == NULL);
+    CHECK(wordle_solver_num_boards(NULL) == 0);
+    wordle_solver_free(NULL);
+
+    wordle_solver* solver = wordle_solver_create(guess_list, word_list, 2);
+    CHECK(solver != NULL);
+
+    if (solver == NULL) {
+        return;
+    }
+
+    CHECK(wordle_solver_num_boards(solver) == 2);
+    CHECK(wordle_solver_last_error()[0] == '\0');
+
+    /* Invalid words and feedback leave the game unchanged. */
+    uint8_t feedback[2] = {0, 0};
+    size_t const before = num_candidates(solver, 0);
+    CHECK(wordle_solver_apply_feedback(solver, "so4re", feedback) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Tried to read in word with letter outside of a-z range!") == 0);
+    CHECK(wordle_solver_apply_feedback(solver, "soar", feedback) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Words must consist of exactly 5 letters!") == 0);
+    feedback[1] = 243;
+    CHECK(wordle_solver_apply_feedback(solver, "soare", feedback) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Invalid feedback code!") == 0);
+    CHECK(wordle_solver_apply_feedback(solver, "soare", NULL) < 0);
+    CHECK(num_candidates(solver, 0) == before);
+
+    CHECK(wordle_solver_parse_feedback("bygbx", &code) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Tried to read in feedback with letter other than b, y or g!") == 0);
+    CHECK(wordle_solver_parse_feedback("bygbb", &code) == 0 && code == 1 * 3 + 2 * 9);
+    CHECK(wordle_solver_last_error()[0] == '\0');
+
+    /* Out of range boards; a successful call clears the message again. */
+    CHECK(wordle_solver_solved(solver, 2) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Invalid board!") == 0);
+    CHECK(wordle_solver_solved(solver, 1) == 0);
+    CHECK(wordle_solver_last_error()[0] == '\0');
+    CHECK(wordle_solver_candidates(solver, 2, &blocks, &num_blocks) < 0);
+    CHECK(strcmp(wordle_solver_last_error(), "Invalid board!") == 0);
+    CHECK(wordle_solver_words(solver, NULL) == NULL);
+    CHECK(wordle_solver_words(solver, &count) != NULL && count > 0);
+
+    wordle_solver_free(solver);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("Usage: ./wordle_c_api_test guess_list.txt word_list.txt\n");
+        return 1;
+    }
+
+    for (size_t secret = 0; secret < 2000; secret += 500) {
+        CHECK(play(argv[1], argv[2], secret) <= 6);
+    }
+
+    test_errors(argv[1], argv[2]);
+
+    printf(failures == 0 ? "All tests passed.\n" : "Some tests failed!\n");
+    return failures == 0 ? 0 : 1;
+}
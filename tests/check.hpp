@@ -0,0 +1,22 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+// Minimal test helpers. Checks may be used from parallel algorithms, only the first few failures are printed.
+inline std::atomic<std::size_t> failures = 0;
+inline std::mutex check_output_mut;
+
+#define CHECK(cond)                                                                            \
+    do {                                                                                       \
+        if (!(cond) && failures++ < 20) {                                                      \
+            std::lock_guard<std::mutex> guard(check_output_mut);                               \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": check failed: " #cond << '\n';     \
+        }                                                                                      \
+    } while (false)
+
+inline int report_failures() {
+    std::cout << (failures == 0 ? "All tests passed.\n" : "Some tests failed!\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+#include "wordle_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+// Differential tests: every fast kernel is compared against the straightforward WordInfo implementation, which is the
+// reference for what the game actually reveals. The real word lists are covered exhaustively, random words over small
+// alphabets add the repeated letter cases that the lists contain only rarely.
+
+// Checks all the ways in which feedback codes have to agree with WordInfo for a single pair.
+void check_pair(Word const guess, Word const truth) {
+    Feedback const f = feedback_code(guess, truth);
+    CHECK(f < num_feedbacks);
+    CHECK((f == all_green) == (guess == truth));
+    CHECK(parse_feedback(feedback_string(f)) == f);
+    CHECK((WordInfo{guess, truth} == WordInfo{guess, feedback_string(f)}));
+    CHECK(WordInfo(guess, truth).check_word(truth));
+}
+
+void test_all_pairs(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    std::for_each(std::execution::par, guesses.begin(), guesses.end(), [&](Word const& guess) {
+        for (Word const& truth : words) {
+            check_pair(guess, truth);
+        }
+    });
+}
+
+void test_pattern_matrix(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    PatternMatrix const matrix{guesses, words};
+    CHECK(matrix.num_words() == words.size());
+
+    std::for_each(std::execution::par, guesses.begin(), guesses.end(), [&](Word const& guess) {
+        auto const row = matrix.row(&guess - guesses.data());
+
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            CHECK(row[w] == feedback_code(guess, words[w]));
+        }
+    });
+}
+
+// The histogram has to count exactly the words that WordInfo considers consistent with each response. This is checked
+// for one representative truth per response and for every "stride"th guess, since it is quadratic in the words.
+void test_histograms(std::vector<Word> const& guesses, std::vector<Word> const& words, std::size_t const stride) {
+    std::vector<std::size_t> sample;
+
+    for (std::size_t g = 0; g < guesses.size(); g += stride) {
+        sample.push_back(g);
+    }
+
+    std::for_each(std::execution::par, sample.begin(), sample.end(), [&](std::size_t const g) {
+        Histogram const histogram = feedback_histogram(guesses[g], words);
+        std::array<bool, num_feedbacks> seen{};
+        std::size_t total = 0;
+
+        for (Word const& truth : words) {
+            Feedback const f = feedback_code(guesses[g], truth);
+
+            if (std::exchange(seen[f], true)) {
+                continue;
+            }
+
+            WordInfo const info{guesses[g], truth};
+            auto const consistent = std::ranges::count_if(words, [&](Word const w) { return info.check_word(w); });
+            CHECK(histogram[f] == static_cast<std::size_t>(consistent));
+            total += histogram[f];
+        }
+
+        CHECK(total == words.size());
+    });
+}
+
+void test_combined_codes(std::vector<Word> const& guesses, std::vector<Word> const& words, std::mt19937_64& rng) {
+    PatternMatrix const matrix{guesses, words};
+    std::uniform_int_distribution<std::size_t> pick{0, guesses.size() - 1};
+
+    for (std::size_t num_guesses = 0; num_guesses <= max_combined_guesses; ++num_guesses) {
+        std::vector<std::size_t> chosen;
+        std::vector<std::span<Feedback const>> rows;
+
+        for (std::size_t i = 0; i < num_guesses; ++i) {
+            chosen.push_back(pick(rng));
+            rows.push_back(matrix.row(chosen.back()));
+        }
+
+        std::vector<CombinedCode> const codes = combined_codes(rows);
+        CHECK(codes.size() == (num_guesses == 0 ? 0 : words.size()));
+
+        for (std::size_t w = 0; w < codes.size(); ++w) {
+            CombinedCode code = codes[w];
+
+            for (std::size_t const g : chosen) {
+                CHECK(code % num_feedbacks == feedback_code(guesses[g], words[w]));
+                code /= num_feedbacks;
+            }
+
+            CHECK(code == 0);
+        }
+
+        std::vector<CombinedCode> sorted = codes;
+        std::ranges::sort(sorted);
+        auto const histogram = combined_histogram(codes, num_guesses);
+        std::size_t offset = 0;
+
+        for (auto const& [code, count] : histogram) {
+            CHECK(static_cast<std::size_t>(std::ranges::count(sorted, code)) == count);
+            CHECK(offset < sorted.size() && sorted[offset] == code);
+            offset += count;
+        }
+
+        CHECK(offset == sorted.size());
+    }
+}
+
+// All histogram kernels have to count the rows of the pattern matrix like feedback_histogram, including rows with only a
+// few buckets and lengths that are not a multiple of the number of lanes or the vector width.
+void test_histogram_kernels(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    PatternMatrix const matrix{guesses, words};
+
+    std::for_each(std::execution::par, guesses.begin(), guesses.end(), [&](Word const& guess) {
+        std::span<Feedback const> const row = matrix.row(&guess - guesses.data());
+        Histogram const expected = feedback_histogram(guess, words);
+
+        for (std::size_t const size : {row.size(), row.size() / 3, std::size_t{17}, std::size_t{0}}) {
+            std::span<Feedback const> const codes = row.first(std::min(size, row.size()));
+            Histogram reference{0};
+
+            for (Feedback const f : codes) {
+                ++reference[f];
+            }
+
+            std::vector<void (*)(std::span<Feedback const>, Histogram&)> kernels{add_codes_scalar,
+                                                                                 add_codes_interleaved, add_codes};
+#if defined(WORDLE_SOLVER_X86)
+            if (has_avx512()) {
+                kernels.push_back(add_codes_avx512);
+            }
+#endif
+
+            for (auto const kernel : kernels) {
+                Histogram h{0};
+                kernel(codes, h);
+                CHECK(h == reference);
+            }
+
+            if (codes.size() == row.size()) {
+                CHECK(reference == expected);
+            }
+        }
+    });
+}
+
+// The filter kernels have to keep exactly the words that check_word accepts, for information from a response as well as
+// from a known truth, and for lists that do not fill their last block. The AVX2 kernel is chosen at runtime, so it is
+// covered by every build on a machine that supports it.
+void test_filter(std::vector<Word> const& guesses, std::vector<Word> const& words, std::size_t const samples,
+                 std::uint64_t const seed) {
+    std::vector<std::uint64_t> seeds(samples);
+    std::iota(seeds.begin(), seeds.end(), seed);
+
+    std::for_each(std::execution::par, seeds.begin(), seeds.end(), [&](std::uint64_t const s) {
+        std::mt19937_64 rng{s};
+        Word const guess = guesses[rng() % guesses.size()];
+        Word const truth = words[rng() % words.size()];
+        std::vector<Word> const& list = s % 2 == 0 ? guesses : words;
+        std::span<Word const> const prefix = std::span{list}.first(rng() % (list.size() + 1));
+        PackedWords const packed{prefix};
+
+        for (WordInfo const& info : {WordInfo{guess, truth}, WordInfo{guess, feedback_string(rng() % all_green)}}) {
+            std::vector<FilterMask (*)(PackedWords const&, WordInfo const&)> kernels{filter_mask_scalar, filter_mask};
+#if defined(WORDLE_SOLVER_X86)
+            if (has_avx2()) {
+                kernels.push_back(filter_mask_avx2);
+            }
+#endif
+
+            for (auto const kernel : kernels) {
+                FilterMask const mask = kernel(packed, info);
+                CHECK(mask.size() == packed.num_blocks());
+
+                for (std::size_t w = 0; w < packed.num_blocks() * packed_block; ++w) {
+                    CHECK(in_mask(mask, w) == (w < prefix.size() && info.check_word(prefix[w])));
+                }
+            }
+
+            std::vector<Word> expected;
+            std::ranges::copy_if(prefix, std::back_inserter(expected),
+                                 [&](Word const w) { return info.check_word(w); });
+            std::vector<Word> const copy{prefix.begin(), prefix.end()};
+            CHECK(filter_words(copy, info) == expected);
+            CHECK(filter_words_packed(copy, info) == expected);
+        }
+    });
+}
+
+// Two words are indistinguishable by a guess exactly if WordInfo says so, for any third word as the truth.
+void test_random_triples(std::vector<Word> const& guesses, std::vector<Word> const& words, std::size_t const samples,
+                         std::uint64_t const seed) {
+    std::vector<std::uint64_t> seeds(samples);
+    std::iota(seeds.begin(), seeds.end(), seed);
+
+    std::for_each(std::execution::par, seeds.begin(), seeds.end(), [&](std::uint64_t const s) {
+        std::mt19937_64 rng{s};
+        Word const guess = guesses[rng() % guesses.size()];
+        Word const truth = words[rng() % words.size()];
+        Word const other = words[rng() % words.size()];
+
+        bool const same = feedback_code(guess, truth) == feedback_code(guess, other);
+        CHECK(WordInfo(guess, truth).check_word(other) == same);
+    });
+}
+
+// Random words over the first "alphabet" letters, so that small alphabets produce many repeated letters.
+std::vector<Word> random_words(std::size_t const count, std::size_t const alphabet, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> letter{0, static_cast<int>(alphabet) - 1};
+    std::vector<Word> result(count);
+
+    for (Word& word : result) {
+        for (char& c : word) {
+            c = static_cast<char>(letter(rng));
+        }
+    }
+
+    std::ranges::sort(result);
+    auto const [first, last] = std::ranges::unique(result);
+    result.erase(first, last);
+    return result;
+}
+
+void test_random_alphabets(std::mt19937_64& rng) {
+    for (std::size_t const alphabet : {1, 2, 3, 4, 6, 10, 26}) {
+        std::vector<Word> const guesses = random_words(300, alphabet, rng);
+        std::vector<Word> const words = random_words(300, alphabet, rng);
+
+        test_all_pairs(guesses, words);
+        test_pattern_matrix(guesses, words);
+        test_histograms(guesses, words, 1);
+        test_histogram_kernels(guesses, words);
+        test_combined_codes(guesses, words, rng);
+        test_random_triples(guesses, words, 20000, rng());
+        test_filter(guesses, words, 200, rng());
+    }
+}
+
+int main(int const argc, char const* const* const argv) {
+    if (argc != 3) {
+        std::cout << "Usage: ./wordle_differential_test guess_list.txt word_list.txt\n";
+        return 1;
+    }
+
+    std::vector<Word> const guesses = load_word_list(argv[1]);
+    std::vector<Word> const words = load_word_list(argv[2]);
+    std::mt19937_64 rng{20220119};
+
+    auto const run = [](char const* name, auto&& test) {
+        auto const start = std::chrono::steady_clock::now();
+        test();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << elapsed.count() << "s\n";
+    };
+
+    run("all pairs", [&] { test_all_pairs(guesses, words); });
+    run("pattern matrix", [&] { test_pattern_matrix(guesses, words); });
+    run("histograms", [&] { test_histograms(guesses, words, 16); });
+    run("histogram kernels", [&] { test_histogram_kernels(guesses, words); });
+    run("combined codes", [&] { test_combined_codes(guesses, words, rng); });
+    run("random triples", [&] { test_random_triples(guesses, words, 1000000, rng()); });
+    run("filter", [&] { test_filter(guesses, words, 2000, rng()); });
+    run("random alphabets", [&] { test_random_alphabets(rng); });
+
+    return report_failures();
+}
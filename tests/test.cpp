@@ -0,0 +1,678 @@
+#include "wordle_solver.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include "check.hpp"
+
+void test_feedback_strings() {
+    for (std::size_t f = 0; f < num_feedbacks; ++f) {
+        CHECK(parse_feedback(feedback_string(f)) == f);
+    }
+
+    CHECK(feedback_code(parse_word("speed"), parse_word("abide")) == parse_feedback("bbyby"));
+    CHECK(feedback_code(parse_word("speed"), parse_word("erase")) == parse_feedback("ybyyb"));
+    CHECK(feedback_code(parse_word("crane"), parse_word("crane")) == all_green);
+}
+
+// The feedback code has to carry exactly the information of WordInfo.
+void test_feedback_matches_word_info(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    for (Word const& guess : guesses | std::views::take(50)) {
+        for (Word const& truth : words) {
+            Feedback const f = feedback_code(guess, truth);
+            CHECK((WordInfo{guess, truth} == WordInfo{guess, feedback_string(f)}));
+        }
+    }
+}
+
+void test_combined_histogram(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    PatternMatrix const matrix{guesses, words};
+    std::vector<std::span<Feedback const>> const rows{matrix.row(0), matrix.row(7), matrix.row(42)};
+    std::vector<CombinedCode> const codes = combined_codes(rows);
+    std::map<CombinedCode, std::uint32_t> expected;
+
+    for (CombinedCode const c : codes) {
+        ++expected[c];
+    }
+
+    auto const histogram = combined_histogram(codes, rows.size());
+    CHECK((histogram == std::vector<std::pair<CombinedCode, std::uint32_t>>{expected.begin(), expected.end()}));
+}
+
+// The fixed point entropy has to rank guesses like the floating point one, with exact ties for guesses whose buckets
+// have the same sizes. Checked at the root and for the largest buckets after one guess.
+void test_fixed_entropy_ranking(std::vector<Word> const& guesses, std::vector<Word> const& words) {
+    std::vector<std::vector<Word>> sets{words};
+    std::vector<std::vector<Word>> buckets(num_feedbacks);
+
+    for (Word const& word : words) {
+        buckets[feedback_code(parse_word("soare"), word)].push_back(word);
+    }
+
+    std::ranges::sort(buckets, std::ranges::greater{}, &std::vector<Word>::size);
+    sets.insert(sets.end(), buckets.begin(), buckets.begin() + 3);
+
+    for (std::vector<Word> const& set : sets) {
+        struct Entry {
+            std::uint64_t fixed;
+            double exact;
+            Histogram sizes;
+        };
+
+        std::vector<Entry> entries;
+
+        for (Word const& guess : guesses) {
+            Histogram const h = feedback_histogram(guess, set);
+            Histogram sizes = h;
+            std::ranges::sort(sizes);
+            entries.push_back({FixedEntropyObjective{}.sum(h), EntropyObjective{}(h, set.size()), sizes});
+        }
+
+        std::ranges::sort(entries, {}, &Entry::fixed);
+
+        // Equal sums have to be ties in exact arithmetic, distinct ones have to be ordered the same way by the floating
+        // point version and further apart than its rounding error.
+        for (std::size_t i = 1; i < entries.size(); ++i) {
+            Entry const& prev = entries[i - 1];
+
+            if (prev.fixed == entries[i].fixed) {
+                CHECK(std::abs(prev.exact - entries[i].exact) < 1e-12);
+            } else {
+                CHECK(prev.sizes != entries[i].sizes);
+                CHECK(entries[i].exact - prev.exact > 1e-12);
+            }
+        }
+
+        CHECK(best_choice(guesses, set, {}, Scoring::fixed_entropy).first ==
+              best_choice(guesses, set, {}, Scoring::entropy).first);
+    }
+}
+
+// Strategies have to survive the trip through the binary and the text format unchanged.
+void test_strategy_round_trip(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    StrategyTree const tree = build_strategy_tree(small, small, {}, true, Scoring::entropy);
+    std::vector<std::uint32_t> const data = serialize_strategy_tree(tree);
+    StrategyView const view{data};
+
+    std::stringstream text;
+    export_strategy_text(view, text);
+    CHECK(serialize_strategy_tree(parse_strategy_text(text)) == data);
+
+    VerifyReport const report = verify_strategy(view, small, 10);
+    CHECK(report.solved == small.size());
+    CHECK(report.hard_mode_violations == 0);
+
+    auto const solutions = strategy_solutions(view, view.root());
+    CHECK(solutions.size() == small.size());
+    CHECK(std::accumulate(solutions.begin(), solutions.end(), std::size_t{0},
+                          [](std::size_t const sum, auto const& s) { return sum + s.second; }) == report.total_guesses);
+}
+
+// Damaged strategy files have to be rejected when they are loaded instead of crashing the traversals later on.
+void test_invalid_strategies(std::vector<Word> const& words) {
+    std::string const path = (std::filesystem::temp_directory_path() / "wordle_test_strategy.bin").string();
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    StrategyTree const tree = build_strategy_tree(small, small, {}, false, Scoring::entropy);
+    std::vector<std::uint32_t> const data = serialize_strategy_tree(tree);
+    std::size_t const root = strategy_header_size + data[2];
+    std::size_t const first_child = root + 1 + strategy_mask_size;
+
+    auto const loads = [&](std::vector<std::uint32_t> const& file_data) {
+        std::ofstream file{path, std::ios::binary};
+        file.write(reinterpret_cast<char const*>(file_data.data()), file_data.size() * sizeof(std::uint32_t));
+        file.close();
+
+        try {
+            LoadedStrategy const strategy{path};
+            return true;
+        } catch (std::runtime_error const&) {
+            return false;
+        }
+    };
+
+    CHECK(loads(data));
+
+    std::vector<std::uint32_t> truncated{data.begin(), data.end() - 1};
+    CHECK(!loads(truncated));
+    --truncated[3];
+    CHECK(!loads(truncated));
+
+    std::vector<std::uint32_t> cyclic = data;
+    cyclic[first_child] = 0;
+    CHECK(!loads(cyclic));
+
+    std::vector<std::uint32_t> mid_node = data;
+    ++mid_node[first_child];
+    CHECK(!loads(mid_node));
+
+    std::vector<std::uint32_t> out_of_range = data;
+    out_of_range[first_child] = data[3];
+    CHECK(!loads(out_of_range));
+
+    // Letters are packed into 5 bits, which leaves room for 6 values that are not letters.
+    std::vector<std::uint32_t> bad_letter = data;
+    bad_letter[strategy_header_size + data[2] - 1] |= 31 << 10;
+    CHECK(!loads(bad_letter));
+
+    std::filesystem::remove(path);
+}
+
+// Second move tables have to agree with a search after the opener, survive the data file and be used by MultiGame.
+void test_second_moves(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    SecondMoveTable const table = build_second_moves(small, small, {}, false, Scoring::entropy);
+    CHECK(table.best_opener);
+    CHECK(table.opener == best_choice(small, small, {}, Scoring::entropy).first);
+
+    for (auto const& [feedback, suggestion] : table.replies) {
+        std::vector<Word> bucket;
+        std::ranges::copy_if(small, std::back_inserter(bucket),
+                             [&](Word const w) { return feedback_code(table.opener, w) == feedback; });
+        CHECK(suggestion == best_choice(small, bucket, {}, Scoring::entropy));
+    }
+
+    DataSections sections;
+    store_second_moves(sections, {table});
+    std::vector<SecondMoveTable> const loaded = load_second_moves(sections);
+    CHECK(loaded.size() == 1);
+    CHECK(loaded.front().applies_to(search_fingerprint(small, small), false, Scoring::entropy));
+    CHECK(loaded.front().opener == table.opener && loaded.front().replies == table.replies);
+
+    Dictionary dict{small, small};
+    dict.second_moves = loaded;
+    MultiGame game{dict, 1};
+    CHECK((game.suggest() == std::pair{table.opener, table.opener_score}));
+
+    auto const& [feedback, suggestion] = table.replies.front();
+    game.apply_feedback(table.opener, std::array{feedback});
+    CHECK(game.suggest() == suggestion);
+}
+
+// Games walked concurrently through the trie have to visit exactly the states of the strategy tree, each with one search
+// at most.
+void test_state_trie(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    std::unordered_map<Word, double> const freqs;
+    StateTrie trie{small, small, freqs, false, Scoring::entropy};
+    std::atomic<std::size_t> total_guesses = 0;
+
+    std::for_each(std::execution::par, small.begin(), small.end(), [&](Word const& secret) {
+        StateTrie::Node* node = &trie.root();
+
+        for (std::size_t guesses = 1;; ++guesses) {
+            Word const guess = trie.best(*node).first;
+            Feedback const f = feedback_code(guess, secret);
+
+            if (f == all_green) {
+                total_guesses += guesses;
+                break;
+            }
+
+            node = &trie.child(*node, guess, f);
+            CHECK(trie.candidates(*node).size() < small.size());
+        }
+    });
+
+    StrategyTree const tree = build_strategy_tree(small, small, {}, false, Scoring::entropy);
+    std::vector<std::uint32_t> const data = serialize_strategy_tree(tree);
+    CHECK(trie.num_nodes() == tree.size());
+    CHECK(trie.num_searches() <= tree.size());
+    CHECK(trie.memory_usage() > trie.num_nodes() * sizeof(StateTrie::Node));
+    CHECK(total_guesses == verify_strategy(StrategyView{data}, small, 10).total_guesses);
+}
+
+// The hash of a word set is kept up to date as words are erased, does not depend on the order of the words and lets the
+// trie share best guesses between guess orders that reach the same candidates.
+void test_set_hash(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    WordSet set{small};
+    CHECK(set.hash() == word_set_hash(small));
+
+    std::vector<Word> kept;
+    set.for_each([&](std::size_t const i) {
+        if (i % 3 == 0) {
+            set.erase(i);
+        } else {
+            kept.push_back(small[i]);
+        }
+    });
+
+    set.erase(0);
+    CHECK(set.hash() == word_set_hash(kept));
+    std::ranges::reverse(kept);
+    CHECK(set.hash() == word_set_hash(kept));
+    CHECK(set.hash() != word_set_hash(small));
+
+    // Hard mode states whose guesses are their candidates must not share a key.
+    CHECK(lookahead_key(small, small, true, 1) != lookahead_key(kept, kept, true, 1));
+    CHECK(lookahead_key(small, small, true, 1) != lookahead_key(small, small, false, 1));
+
+    std::unordered_map<Word, double> const freqs;
+    StateTrie trie{small, small, freqs, true, Scoring::entropy};
+    Word const first = small[0];
+    Word const second = small[150];
+    Word const secret = small[200];
+    Feedback const f1 = feedback_code(first, secret);
+    Feedback const f2 = feedback_code(second, secret);
+    StateTrie::Node& a = trie.child(trie.child(trie.root(), first, f1), second, f2);
+    StateTrie::Node& b = trie.child(trie.child(trie.root(), second, f2), first, f1);
+    CHECK(&a != &b);
+    CHECK(StateTrie::state_hash(a) == StateTrie::state_hash(b));
+    CHECK(StateTrie::state_hash(a) != StateTrie::state_hash(trie.root()));
+    CHECK(trie.best(a) == trie.best(b));
+    CHECK(trie.num_transpositions() == (trie.candidates(a).size() > 1 ? 1u : 0u));
+}
+
+// Replacement policy of a single bucket, consistency of entries under concurrent stores and probes, and lookahead
+// results that do not depend on how many entries the table can keep.
+void test_transposition_table(std::vector<Word> const& words) {
+    using Entry = TranspositionTable::Entry;
+    TranspositionTable single{64};
+    CHECK(single.memory_usage() == 64);
+
+    single.store(1, Entry{words[1], 1.5, 5});
+    single.store(2, Entry{words[2], 2.5, 1});
+    CHECK(single.probe(1) && single.probe(1)->best == words[1] && single.probe(1)->depth == 5);
+    CHECK(single.probe(2) && single.probe(2)->score == 2.5);
+    CHECK(single.fill_rate() == 1.0);
+    CHECK(single.collisions() == 0);
+
+    single.store(3, Entry{words[3], 3.5, 0});
+    CHECK(single.probe(1) && !single.probe(2) && single.probe(3));
+    CHECK(single.collisions() == 1);
+
+    single.new_search();
+    single.store(4, Entry{words[4], 4.5, 0});
+    CHECK(!single.probe(1) && single.probe(3) && single.probe(4));
+    CHECK(single.collisions() == 1);
+
+    single.clear();
+    CHECK(single.fill_rate() == 0.0 && !single.probe(4));
+
+    // The data of an entry is derived from its key, so any torn read would show up as a mismatch.
+    TranspositionTable shared{1 << 12};
+    std::vector<std::uint64_t> keys(1 << 16);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    std::for_each(std::execution::par, keys.begin(), keys.end(), [&](std::uint64_t const i) {
+        std::uint64_t const key = mix64(i % 1000);
+        Word const best = words[key % words.size()];
+        auto const depth = static_cast<std::uint8_t>(key % 7);
+
+        if (i % 3 == 0) {
+            shared.store(key, Entry{best, static_cast<double>(key >> 11), depth});
+        } else if (std::optional<Entry> const entry = shared.probe(key)) {
+            CHECK(entry->best == best && entry->score == static_cast<double>(key >> 11) && entry->depth == depth);
+        }
+    });
+
+    CHECK(shared.hits() > 0 && shared.hits() <= shared.probes());
+    CHECK(shared.fill_rate() > 0.0 && shared.fill_rate() <= 1.0);
+
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    CostModel const model;
+    TranspositionTable tiny{64};
+    auto const expected = best_choice_lookahead(small, small, model, false, 2, 4);
+    CHECK(best_choice_lookahead(small, small, model, false, 2, 4, tiny) == expected);
+    CHECK(tiny.collisions() > 0);
+    tiny.new_search();
+    CHECK(best_choice_lookahead(small, small, model, false, 2, 4, tiny) == expected);
+}
+
+// Splitting every state into parallel tasks has to give exactly the result of the serial search with pruning.
+void test_parallel_lookahead(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    CostModel const model;
+    std::size_t const serial = std::numeric_limits<std::size_t>::max();
+
+    for (bool const hard_mode : {false, true}) {
+        TranspositionTable serial_table{default_table_bytes};
+        TranspositionTable parallel_table{default_table_bytes};
+        auto const expected = best_choice_lookahead(small, small, model, hard_mode, 3, 3, serial_table, serial);
+        CHECK(best_choice_lookahead(small, small, model, hard_mode, 3, 3, parallel_table, 1) == expected);
+        CHECK(parallel_table.stores() >= serial_table.stores());
+    }
+}
+
+// Replaying a game played by best_choice has to find every guess optimal, and the text strategy format has to parse as
+// a recorded game.
+void test_replay(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    Word const secret = small[123];
+    std::vector<Word> remaining = small;
+    std::vector<SuggestionCache::Turn> game;
+
+    while (game.empty() || game.back().second != all_green) {
+        Word const guess = best_choice(small, remaining, {}, Scoring::entropy).first;
+        Feedback const f = feedback_code(guess, secret);
+        game.emplace_back(guess, f);
+        std::erase_if(remaining, [&](Word const w) { return feedback_code(guess, w) != f; });
+    }
+
+    GameReplayer replayer{small, small, false};
+    std::vector<MoveMetrics> const moves = replayer.replay(game);
+    CHECK(moves.size() == game.size());
+    CHECK(moves.back().remaining == 1);
+
+    for (MoveMetrics const& m : moves) {
+        CHECK(m.guess == m.best_guess);
+        CHECK(std::abs(m.skill() - 1.0) < 1e-12);
+    }
+
+    // Replaying again needs no further searches, states with a single candidate need none at all.
+    CHECK(replayer.replay(game).size() == game.size());
+    CHECK(replayer.cache_misses() ==
+          static_cast<std::size_t>(std::ranges::count_if(moves, [](MoveMetrics const& m) { return m.candidates > 1; })));
+
+    // Many threads replaying from the root without a cache wait for the same search; a thread inside the parallel
+    // search must not pick up another game that reaches the node it is searching. The arena has more threads than
+    // there are cores, so that this also happens on a single core.
+    tbb::global_control const threads{tbb::global_control::max_allowed_parallelism, 8};
+    tbb::task_arena arena{8};
+    GameReplayer concurrent{small, small, false};
+    std::vector<std::vector<SuggestionCache::Turn>> games;
+
+    for (Word const w : small) {
+        games.push_back({{small.front(), feedback_code(small.front(), w)}, {w, all_green}});
+    }
+
+    std::vector<std::vector<MoveMetrics>> replays(games.size());
+    arena.execute([&] {
+        std::transform(std::execution::par, games.begin(), games.end(), replays.begin(),
+                       [&](auto const& g) { return concurrent.replay(g); });
+    });
+
+    for (std::vector<MoveMetrics> const& r : replays) {
+        CHECK(!r.empty() && r.front().best_guess == moves.front().best_guess);
+    }
+
+    auto const parsed = parse_recorded_game("soare BBBBB clint BBBBB dumpy GGGGG3");
+    CHECK(parsed.size() == 3);
+    CHECK(parsed.back() == SuggestionCache::Turn(parse_word("dumpy"), all_green));
+}
+
+// Cached suggestions have to be found for any order of the same turns, survive a reload and stay in their context.
+void test_suggestion_cache() {
+    std::string const path = (std::filesystem::temp_directory_path() / "wordle_test_suggestions.txt").string();
+    std::filesystem::remove(path);
+
+    using Turn = SuggestionCache::Turn;
+    std::vector<Turn> const history{{parse_word("soare"), parse_feedback("bbybg")},
+                                    {parse_word("clint"), parse_feedback("bbbbb")}};
+    std::vector<Turn> const permuted{history[1], history[0], history[1]};
+
+    SuggestionCache cache{path, "test"};
+    CHECK(!cache.find(history));
+    cache.insert(history, {parse_word("puked"), 0.25});
+    CHECK((cache.find(permuted) == std::optional{std::pair{parse_word("puked"), 0.25}}));
+
+    SuggestionCache const reloaded{path, "test"};
+    CHECK(reloaded.size() == 1);
+    CHECK((reloaded.find(permuted) == std::optional{std::pair{parse_word("puked"), 0.25}}));
+    CHECK(!reloaded.find(std::span{history}.first(1)));
+
+    // Lines of other contexts, repeated and unreadable lines are dropped from the file when it is loaded.
+    {
+        std::ofstream file{path, std::ios::app};
+        file << "other\tx\tcrane 1\n" << "test\tclint:bbbbb soare:bbybg\tcrane 0.5\n" << "test\tbroken\n";
+    }
+
+    CHECK(SuggestionCache(path, "test").size() == 1);
+    std::ifstream file{path};
+    std::string line;
+    std::size_t num_lines = 0;
+
+    while (std::getline(file, line)) {
+        CHECK(line.starts_with("test\t") && line.ends_with("puked 0.25"));
+        ++num_lines;
+    }
+
+    CHECK(num_lines == 1);
+    CHECK(SuggestionCache(path, "other").size() == 0);
+    std::filesystem::remove(path);
+}
+
+// A search resumed from its checkpoint skips the finished guesses and buckets and finds the same result, checkpoints
+// are written in the background and only apply to the settings they were written for.
+void test_checkpoint(std::vector<Word> const& words) {
+    std::string const path = (std::filesystem::temp_directory_path() / "wordle_test_checkpoint.bin").string();
+    std::filesystem::remove(path);
+
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    CostModel const model;
+    std::uint64_t const fingerprint = lookahead_fingerprint(small, small, model, false, 3, 3);
+    CHECK(fingerprint != lookahead_fingerprint(small, small, model, true, 3, 3));
+    auto const expected = best_choice_lookahead(small, small, model, false, 3, 3);
+
+    {
+        TranspositionTable table{1 << 20};
+        SearchCheckpoint checkpoint{path, fingerprint, table, std::chrono::milliseconds{1}};
+        CHECK(!checkpoint.resume());
+        CHECK(checkpointed_lookahead(checkpoint, small, small, model, false, 3, 3, table) == expected);
+        CHECK(checkpoint.num_finished() == 3);
+        CHECK(checkpoint.num_finished_buckets() > 0);
+        CHECK(table.entries().size() > 0 && table.entries().size() <= table.stores());
+
+        while (checkpoint.num_writes() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    // Nothing is written before the writer is started, in particular not while the checkpoint is loaded.
+    auto const written = std::filesystem::last_write_time(path);
+
+    {
+        TranspositionTable table{1 << 20};
+        SearchCheckpoint checkpoint{path, fingerprint, table, std::chrono::milliseconds{1}};
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        CHECK(checkpoint.resume());
+        CHECK(checkpoint.num_writes() == 0);
+    }
+
+    CHECK(std::filesystem::last_write_time(path) == written);
+
+    {
+        TranspositionTable table{1 << 20};
+        SearchCheckpoint checkpoint{path, fingerprint, table, std::chrono::hours{1}};
+        CHECK(checkpoint.resume());
+        CHECK(checkpoint.num_finished() == 3);
+        CHECK(checkpoint.num_finished_buckets() > 0);
+        std::size_t const restored = table.stores();
+        CHECK(restored > 0);
+        CHECK(checkpointed_lookahead(checkpoint, small, small, model, false, 3, 3, table) == expected);
+        CHECK(table.stores() == restored);
+    }
+
+    {
+        TranspositionTable table{1 << 20};
+        SearchCheckpoint other{path, fingerprint + 1, table, std::chrono::hours{1}};
+        CHECK(!other.resume());
+        CHECK(other.num_finished() == 0 && table.stores() == 0);
+    }
+
+    std::filesystem::remove(path);
+}
+
+// With a fixed seed, one thread and a fixed number of rollouts the search is deterministic, and always playing its
+// most visited guess has to find every secret word.
+void test_mcts(std::vector<Word> const& words) {
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    MctsOptions options;
+    options.budget = std::chrono::hours{1};
+    options.max_rollouts = 300;
+    options.threads = 1;
+    options.seed = 7;
+
+    auto const suggest = [&](std::vector<Word> const& remaining) {
+        MctsNode root{remaining, small, options, true};
+        MctsResult const result = mcts_search(root, small, {}, options);
+        CHECK(result.rollouts == options.max_rollouts);
+
+        std::vector<std::pair<Word, std::size_t>> ranking;
+
+        for (MctsEdge const* edge : result.ranking) {
+            ranking.emplace_back(edge->guess, edge->visits);
+        }
+
+        return ranking;
+    };
+
+    auto const ranking = suggest(small);
+    CHECK(!ranking.empty() && ranking == suggest(small));
+
+    for (std::size_t s = 0; s < small.size(); s += 30) {
+        std::vector<Word> remaining = small;
+        std::size_t turns = 0;
+
+        while (turns < 8) {
+            ++turns;
+            Word const guess = remaining.size() == small.size() ? ranking.front().first : suggest(remaining)[0].first;
+
+            if (guess == small[s]) {
+                break;
+            }
+
+            remaining = filter_words(remaining, WordInfo{guess, small[s]});
+        }
+
+        CHECK(turns <= 6);
+    }
+}
+
+// Workers on localhost, one of which fails to start and one of which dies after its first task, have to find the
+// same guesses as the local lookahead.
+void test_distributed(std::vector<Word> const& words, std::string const& solver) {
+    std::filesystem::path const dir = std::filesystem::temp_directory_path() / "wordle_test_distributed";
+    std::filesystem::create_directories(dir);
+    std::vector<Word> const small{words.begin(), words.begin() + 300};
+    std::ofstream list{dir / "words.txt"};
+
+    for (Word const& w : small) {
+        list << w << '\n';
+    }
+
+    list.close();
+    CostModel const model;
+    DataSections sections;
+    store_cost_model(sections, model);
+    save_data_file(sections, (dir / "data.bin").string());
+
+    using Turn = SuggestionCache::Turn;
+    std::vector<Turn> const history{{small[0], feedback_code(small[0], small[200])}};
+
+    for (bool const hard_mode : {false, true}) {
+        std::string const worker = '\'' + solver + "' worker " + (dir / "words.txt").string() + ' ' +
+                                   (dir / "words.txt").string() + ' ' + (dir / "data.bin").string() + ' ' +
+                                   std::to_string(hard_mode) + " 3 3 16";
+        WorkerPool pool{{worker, "exit 1", "read -r task; exit 1", worker}};
+
+        // A batch large enough that the broken workers get to fail often enough to be dropped, since the searches
+        // below hand out their eldest guess alone.
+        std::vector<std::string> tasks;
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            tasks.push_back(lookahead_task({}, small[i], std::numeric_limits<double>::max()));
+        }
+
+        auto const replies = pool.run(tasks);
+
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            std::istringstream reply{replies[i]};
+            Word guess;
+            CHECK(reply >> guess && guess == small[i]);
+        }
+
+        for (std::size_t turns = 0; turns <= history.size(); ++turns) {
+            auto const [guesses, remaining] = narrow_down(std::span{history}.first(turns), small, small, hard_mode);
+            auto const expected = best_choice_lookahead(guesses, remaining, model, hard_mode, 3, 3);
+            CHECK(distributed_lookahead(pool, std::span{history}.first(turns), guesses, remaining, model, hard_mode,
+                                        3, 3) == expected);
+        }
+
+        CHECK(pool.num_workers() == 2);
+        CHECK(pool.num_failures() >= 4);
+    }
+
+    // The cutoff in a task lets the worker give up a guess that cannot beat it, without changing exact costs below.
+    auto const serve = [&](Word const guess, double const cutoff) {
+        TranspositionTable table{1 << 20};
+        std::istringstream reply{serve_lookahead_task(lookahead_task({}, guess, cutoff), small, small, model, false,
+                                                      3, 3, table)};
+        Word replied;
+        double cost = 0.0;
+        CHECK(reply >> replied >> cost && replied == guess);
+        return std::pair{cost, table.stores()};
+    };
+
+    auto const [best_guess, best_cost] = best_choice_lookahead(small, small, model, false, 3, 3);
+    auto const [exact, exact_stores] = serve(best_guess, std::numeric_limits<double>::max());
+    auto const [given_up, given_up_stores] = serve(best_guess, 1.0);
+    CHECK(exact == best_cost && serve(best_guess, best_cost + 0.5).first == best_cost);
+    CHECK(given_up >= 1.0 && given_up_stores < exact_stores);
+
+    WorkerPool broken{{"exit 1"}, 2};
+    bool threw = false;
+
+    try {
+        broken.run({"task"});
+    } catch (std::runtime_error const&) {
+        threw = true;
+    }
+
+    CHECK(threw && broken.num_workers() == 0 && broken.num_failures() == 2);
+
+    // A worker that hangs (with a child process that would keep it busy) is killed after the timeout and its task
+    // handed to the other worker.
+    WorkerPool hanging{{"read -r task; sleep 60; echo late", "while read -r task; do echo done; done"}, 1,
+                       std::chrono::milliseconds{200}};
+    auto const start = std::chrono::steady_clock::now();
+    CHECK(hanging.run({"a", "b", "c"}) == std::vector<std::string>(3, "done"));
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{10});
+    CHECK(hanging.num_workers() == 1 && hanging.num_failures() == 1);
+    std::filesystem::remove_all(dir);
+}
+
+int main(int const argc, char const* const* const argv) {
+    if (argc < 3 || argc > 4) {
+        std::cout << "Usage: ./wordle_test guess_list.txt word_list.txt [wordle_solver]\n";
+        return 1;
+    }
+
+    std::vector<Word> const guesses = load_word_list(argv[1]);
+    std::vector<Word> const words = load_word_list(argv[2]);
+
+    test_feedback_strings();
+    test_feedback_matches_word_info(guesses, words);
+    test_combined_histogram(guesses, words);
+    test_fixed_entropy_ranking(guesses, words);
+    test_strategy_round_trip(words);
+    test_invalid_strategies(words);
+    test_suggestion_cache();
+    test_second_moves(words);
+    test_state_trie(words);
+    test_set_hash(words);
+    test_transposition_table(words);
+    test_parallel_lookahead(words);
+    test_replay(words);
+    test_checkpoint(words);
+    test_mcts(words);
+
+    if (argc == 4) {
+        test_distributed(words, argv[3]);
+    }
+
+    return report_failures();
+}
@@ -1,348 +1,1060 @@
-#include <algorithm>
-#include <array>
+#include "wordle_solver.hpp"
+
 #include <chrono>
-#include <cmath>
-#include <execution>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <limits>
-#include <mutex>
-#include <random>
-#include <ranges>
-#include <stdexcept>
-#include <unordered_map>
-#include <utility>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
-using Word = std::array<char, 5>;
+// Main game loop: "suggest" computes the next guess and its score for the current guesses and remaining words (and the
+// turns so far, if it takes them), which are narrowed down by the responses entered by the user. Suggestions are looked
+// up in and added to "cache" if given.
+template <typename Fn>
+void interactive_loop(std::vector<Word> guess_list, std::vector<Word> word_list, bool const hard_mode,
+                      std::string_view const description, Fn&& suggest, SuggestionCache* const cache = nullptr) {
+    std::vector<SuggestionCache::Turn> history;
 
-std::ostream& operator<<(std::ostream& os, Word const& w) {
-    for (char const c : w) {
-        os << static_cast<char>(c + 'a');
-    }
+    while (true) {
+        auto const st = std::chrono::high_resolution_clock::now();
+        std::optional<SuggestionCache::Suggestion> const cached = cache ? cache->find(history) : std::nullopt;
+        auto const [guess, score] = [&] {
+            if (cached) {
+                return *cached;
+            } else if constexpr (std::is_invocable_v<Fn&, std::vector<Word> const&, std::vector<Word> const&,
+                                                     std::vector<SuggestionCache::Turn> const&>) {
+                return std::invoke(suggest, guess_list, word_list, history);
+            } else {
+                return std::invoke(suggest, guess_list, word_list);
+            }
+        }();
+        auto const ct = std::chrono::high_resolution_clock::now();
 
-    return os;
-}
+        // Without remaining words there is nothing worth remembering (and the score is meaningless).
+        if (cache && !cached && !word_list.empty()) {
+            cache->insert(history, {guess, score});
+        }
 
-std::istream& operator>>(std::istream& is, Word& w) {
-    for (char& c : w) {
-        is >> c;
+        std::cout << "Best guess is \"" << guess << "\" with " << description << ' ' << score << ".\n";
+        std::cout << (cached ? "Cache lookup took " : "Computation took ")
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count() << " ms.\n";
 
-        if (c < 'a' || c > 'z') {
-            throw std::invalid_argument("Tried to read in word with letter outside of a-z range!");
-        }
+        // Responses that no remaining word gives (typos, or impossible under a strategy) are asked for again.
+        std::optional<Feedback> feedback;
+        std::vector<Word> remaining;
 
-        c -= 'a';
-    }
+        while (remaining.empty()) {
+            std::cout << "Response (b|y|g) * 5: ";
+            std::string info_string;
 
-    return is;
-}
+            if (!(std::cin >> info_string)) {
+                return;
+            }
 
-// This represents the information that was obtained from "guess". Instead of storing the colored squares, we use a
-// representation which allows us to test whether another word matches this information very efficiently.
-struct WordInfo {
-    Word guess;
-    std::array<bool, 5> correct_letters;
-    std::array<char, 26> min_counts;
-    std::array<char, 26> max_counts;
-
-    WordInfo(Word const guess, Word const truth) : guess{guess} {
-        for (std::size_t i = 0; i < 5; ++i) {
-            correct_letters[i] = (guess[i] == truth[i]);
-        }
+            try {
+                feedback = parse_feedback(info_string);
+            } catch (std::invalid_argument const& e) {
+                std::cout << e.what() << '\n';
+                continue;
+            }
+
+            if (*feedback == all_green) {
+                return;
+            }
 
-        std::array<char, 26> guess_counts{0};
-        std::array<char, 26> truth_counts{0};
+            remaining = filter_words(word_list, WordInfo{guess, feedback_string(*feedback)});
 
-        for (char const c : guess) {
-            ++guess_counts[c];
+            if (remaining.empty()) {
+                std::cout << "No remaining word gives this response!\n";
+            }
         }
 
-        for (char const c : truth) {
-            ++truth_counts[c];
+        history.emplace_back(guess, *feedback);
+        word_list = std::move(remaining);
+
+        if (hard_mode) {
+            guess_list = filter_words(guess_list, WordInfo{guess, feedback_string(*feedback)});
         }
 
-        for (std::size_t i = 0; i < 26; ++i) {
-            if (guess_counts[i] <= truth_counts[i]) {
-                min_counts[i] = guess_counts[i];
-                max_counts[i] = 5;
-            } else {
-                min_counts[i] = truth_counts[i];
-                max_counts[i] = truth_counts[i];
+        if (word_list.size() < 10) {
+            std::cout << "Remaining words:";
+
+            for (Word const& w : word_list) {
+                std::cout << ' ' << w;
             }
+
+            std::cout << '\n';
         }
     }
+}
 
-    WordInfo(Word const guess, std::string const& info) : guess{guess}, min_counts{} {
-        std::ranges::fill(max_counts, 5);
+// Directory of the suggestion caches: $WORDLE_SOLVER_CACHE if set (an empty value disables the cache), otherwise in
+// ~/.cache.
+std::string suggestion_cache_dir() {
+    std::filesystem::path dir;
 
-        for (std::size_t i = 0; i < 5; ++i) {
-            if (info[i] == 'g') {
-                correct_letters[i] = true;
-                ++min_counts[guess[i]];
-                continue;
-            }
+    if (char const* const path = std::getenv("WORDLE_SOLVER_CACHE")) {
+        dir = path;
+    } else if (char const* const home = std::getenv("HOME")) {
+        dir = std::filesystem::path{home} / ".cache" / "wordle_solver";
+    }
 
-            correct_letters[i] = false;
+    if (dir.empty()) {
+        return "";
+    }
 
-            if (info[i] == 'y') {
-                ++min_counts[guess[i]];
-            }
-        }
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    return error ? "" : dir.string();
+}
 
-        for (std::size_t i = 0; i < 5; ++i) {
-            if (info[i] == 'b') {
-                max_counts[guess[i]] = min_counts[guess[i]];
-            }
-        }
-    }
+// Cache for the suggestions of one mode, "settings" has to describe everything besides the word lists and frequency
+// data that changes the suggestions. Every context has a file of its own, named by a hash of the context.
+SuggestionCache open_suggestion_cache(std::vector<Word> const& guess_list, std::vector<Word> const& word_list,
+                                      std::unordered_map<Word, double> const& freq_data, std::string const& settings,
+                                      std::ostream& log = std::cout) {
+    std::ostringstream context;
+    context << std::hex << search_fingerprint(guess_list, word_list, freq_data) << ' ' << settings;
 
-    bool check_word(Word const word) const {
-        std::array<char, 26> counts{0};
+    std::string const dir = suggestion_cache_dir();
+    std::string path;
 
-        for (std::size_t i = 0; i < 5; ++i) {
-            if ((word[i] == guess[i]) != correct_letters[i]) {
-                return false;
-            }
+    if (!dir.empty()) {
+        std::uint64_t hash = 0;
 
-            if (++counts[word[i]] > max_counts[word[i]]) {
-                return false;
-            }
+        for (char const c : context.str()) {
+            hash = mix64(hash ^ static_cast<unsigned char>(c));
         }
 
-        return std::ranges::all_of(guess, [&](char const c) { return counts[c] >= min_counts[c]; });
+        std::ostringstream name;
+        name << "suggestions-" << std::hex << hash << ".txt";
+        path = (std::filesystem::path{dir} / name.str()).string();
+    }
+
+    SuggestionCache cache{path, context.str()};
+
+    if (cache.size() > 0) {
+        log << "Loaded " << cache.size() << " cached suggestions from " << path << "!\n";
     }
 
-    bool operator==(WordInfo const& other) const = default;
+    return cache;
+}
+
+// Settings shared by all modes that search for guesses, read from the optional trailing command line arguments.
+struct SolverOptions {
+    bool hard_mode = false;
+    Scoring scoring = Scoring::entropy;
+    std::unordered_map<Word, double> freq_data;
 };
 
-// See boost::hash_combine
-template <typename T>
-void hash_combine(std::size_t& h, T const& c) {
-    h ^= std::hash<T>()(c) + 0x9e3779b9 + (h << 6) + (h >> 2);
+SolverOptions parse_solver_options(std::span<char const* const> const args) {
+    SolverOptions result;
+    // Hard mode: only allow guesses that conform to previous information
+    result.hard_mode = args.size() >= 1 && std::atoi(args[0]) > 0;
+    // Objective to minimize, e.g. adversarial: assume correct word is being changed adversarially
+    result.scoring = args.size() >= 2 ? parse_scoring(args[1]) : Scoring::entropy;
+
+    // Load list of word frequency information for tie breaker
+    if (args.size() >= 3) {
+        result.freq_data = load_freq_data(args[2]);
+        std::cout << "Loaded word frequency data for " << result.freq_data.size() << " words!\n";
+    }
+
+    return result;
 }
 
-template <>
-struct std::hash<Word> {
-    std::size_t operator()(Word const& word) const noexcept {
-        std::size_t h1 = 0;
+// Data file with the precomputed second guesses: $WORDLE_SOLVER_DATA if set, otherwise the one generated by the build.
+std::string default_data_path() {
+    if (char const* const path = std::getenv("WORDLE_SOLVER_DATA")) {
+        return path;
+    }
+
+#ifdef WORDLE_DATA_FILE
+    return WORDLE_DATA_FILE;
+#else
+    return "";
+#endif
+}
 
-        for (std::size_t i = 0; i < 5; ++i) {
-            h1 += static_cast<std::size_t>(word[i]) << (i * 8);
-        }
+// Second move tables from the default data file, a missing file just means that there are none.
+std::vector<SecondMoveTable> load_default_second_moves(std::ostream& log = std::cout) {
+    std::string const path = default_data_path();
 
-        return std::hash<std::size_t>()(h1);
+    if (path.empty() || !std::filesystem::exists(path)) {
+        return {};
     }
-};
 
-// Note: the hash of WordInfo *ignores* the underlying guess. This is because we will only ever compare WordInfos for
-// the same guess.
-template <>
-struct std::hash<WordInfo> {
-    std::size_t operator()(WordInfo const& info) const noexcept {
-        std::size_t h1 = 0, h2 = 0, h3 = 0;
+    std::vector<SecondMoveTable> result = load_second_moves(load_data_file(path));
+    log << "Loaded second guesses for " << result.size() << " openers from " << path << "!\n";
+    return result;
+}
+
+constexpr char const* usage =
+    "Usage: ./wordle_solver guess_list.txt word_list.txt [hard mode = 0/1] [objective = 0/1/name] [freq_data.txt]\n"
+    "       ./wordle_solver build guess_list.txt word_list.txt strategy.bin [hard mode = 0/1] [objective = 0/1/name] "
+    "[freq_data.txt]\n"
+    "       ./wordle_solver export strategy.bin strategy.txt\n"
+    "       ./wordle_solver play strategy.bin\n"
+    "       ./wordle_solver verify strategy.bin|strategy.txt word_list.txt [hard mode = 0/1] [max guesses = 6]\n"
+    "       ./wordle_solver fit guess_list.txt word_list.txt data.bin [hard mode = 0/1] [objective = 0/1/name] "
+    "[freq_data.txt]\n"
+    "       ./wordle_solver lookahead guess_list.txt word_list.txt data.bin [hard mode = 0/1] [depth = 2] "
+    "[width = 8] [table MiB = 256]\n"
+    "       ./wordle_solver search guess_list.txt word_list.txt data.bin checkpoint.bin [resume = 0/1] "
+    "[hard mode = 0/1] [depth = 3] [width = 8] [checkpoint interval in s = 60] [table MiB = 256]\n"
+    "       ./wordle_solver distributed guess_list.txt word_list.txt data.bin workers|workers.txt [hard mode = 0/1] "
+    "[depth = 2] [width = 8] [worker timeout in s = 600]\n"
+    "       ./wordle_solver worker guess_list.txt word_list.txt data.bin [hard mode = 0/1] [depth = 2] [width = 8] "
+    "[table MiB = 256]\n"
+    "       ./wordle_solver mcts guess_list.txt word_list.txt [time budget in ms = 1000] [freq_data.txt]\n"
+    "       ./wordle_solver beam guess_list.txt word_list.txt [number of guesses = 2] [beam width = 16] "
+    "[objective = 0/1/name]\n"
+    "       ./wordle_solver opener word_list.txt guess1 [guess2 ... guess8]\n"
+    "       ./wordle_solver multi guess_list.txt word_list.txt [number of boards = 4]\n"
+    "       ./wordle_solver simulate guess_list.txt word_list.txt [number of games = 0 (all)] [hard mode = 0/1] "
+    "[objective = 0/1/name] [freq_data.txt]\n"
+    "       ./wordle_solver second guess_list.txt word_list.txt data.bin [hard mode = 0/1] [objective = 0/1/name] "
+    "[--freqs freq_data.txt] [--opener word ...]\n"
+    "       ./wordle_solver replay guess_list.txt word_list.txt games.txt|- metrics.csv|- [hard mode = 0/1]\n";
+
+int run_build(std::span<char const* const> const args) {
+    if (args.size() < 3 || args.size() > 6) {
+        std::cout << usage;
+        return 0;
+    }
 
-        for (std::size_t i = 0; i < 5; ++i) {
-            h1 += static_cast<std::size_t>(info.correct_letters[i]) << i;
-        }
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
 
-        for (std::size_t i = 0; i < 19; ++i) {
-            h1 += static_cast<std::size_t>(info.min_counts[i]) << (i * 3 + 5);
-        }
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
 
-        for (std::size_t i = 19; i < 26; ++i) {
-            h2 += static_cast<std::size_t>(info.min_counts[i]) << ((i - 19) * 3);
-        }
+    SolverOptions const options = parse_solver_options(args.subspan(3));
 
-        for (std::size_t i = 0; i < 13; ++i) {
-            h2 += static_cast<std::size_t>(info.max_counts[i]) << ((i + 7) * 3);
-        }
+    auto const st = std::chrono::high_resolution_clock::now();
+    StrategyTree const tree =
+        build_strategy_tree(guess_list, word_list, options.freq_data, options.hard_mode, options.scoring);
+    auto const ct = std::chrono::high_resolution_clock::now();
 
-        for (std::size_t i = 13; i < 26; ++i) {
-            h3 += static_cast<std::size_t>(info.max_counts[i]) << ((i - 13) * 3);
-        }
+    save_strategy_tree(tree, args[2]);
+    std::cout << "Saved strategy with " << tree.size() << " nodes to " << args[2] << ".\n";
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+              << " ms.\n";
+    return 0;
+}
 
-        hash_combine(h1, h2);
-        hash_combine(h1, h3);
-        return h1;
+int run_export(std::span<char const* const> const args) {
+    if (args.size() != 2) {
+        std::cout << usage;
+        return 0;
     }
-};
 
-template <typename Fn, typename T>
-concept Reduction = requires(Fn&& f, T x, T y) {
-    x = std::invoke(f, x, y);
-};
+    LoadedStrategy const strategy{args[0]};
+    std::ofstream out{args[1]};
+    export_strategy_text(strategy.view(), out);
+    return 0;
+}
 
-// Main function: determine the best word from "allowed_choices" given that we know that only "remaining_words" are
-// possible solutions. Ties are broken based on how common we think certain words are ("word_freqs"). The "best" choice
-// is assumed to be the one which maximizes some function of the entropy (i.e. log_2(size)) of the remaining words,
-// typically either average (random choice) or maximum (adversarial choice).
-template <typename Fn>
-std::pair<Word, double> best_choice(std::vector<Word> const& allowed_choices, std::vector<Word> const& remaining_words,
-                                    std::unordered_map<Word, double> const& word_freqs,
-                                    Fn&& fn) requires Reduction<Fn, double> {
-    Word result = allowed_choices.front();
-    std::tuple<double, bool, double> objective{std::numeric_limits<double>::infinity(), true, 0.0};
-    std::mutex result_mut;
-
-    // We use std parallelization for free performance! Note that we cannot use std::execution::par_unseq because we use
-    // a mutex!
-    std::for_each(std::execution::par, allowed_choices.begin(), allowed_choices.end(), [&](Word const& guess) {
-        double total_entropy = 0.0;
-        std::unordered_map<WordInfo, double> memo_map;  // We can memoize entropy computation if we happen to get the
-                                                        // same information for different words.
-
-        for (Word const& truth : remaining_words) {
-            WordInfo const guess_info{guess, truth};
-
-            if (auto const it = memo_map.find(guess_info); it != memo_map.end()) {
-                total_entropy = std::invoke(fn, total_entropy, it->second);
-                continue;
-            }
+int run_play(std::span<char const* const> const args) {
+    if (args.size() != 1) {
+        std::cout << usage;
+        return 0;
+    }
 
-            double const entropy = std::log2(std::ranges::count_if(
-                remaining_words, [&guess_info, truth](Word const& w) { return guess_info.check_word(w); }));
-            total_entropy = std::invoke(fn, total_entropy, entropy);
-            memo_map[guess_info] = entropy;
+    // The words solved by the strategy take the place of the word list, so that responses that are impossible under
+    // the strategy are rejected. Walking the tree along the history gives the next guess, no search is performed.
+    LoadedStrategy const strategy{args[0]};
+    StrategyView const& view = strategy.view();
+    std::vector<Word> word_list;
 
-            if (total_entropy > std::get<0>(objective)) {
-                break;
-            }
-        }
+    for (auto const& [word, guesses] : strategy_solutions(view, view.root())) {
+        word_list.push_back(word);
+    }
 
-        if (total_entropy > std::get<0>(objective)) {
-            return;
-        }
+    interactive_loop({}, std::move(word_list), false, "expected guesses",
+                     [&](std::vector<Word> const&, std::vector<Word> const&,
+                         std::vector<SuggestionCache::Turn> const& history) {
+                         StrategyView::Node node = view.root();
 
-        // Tiebreakers
-        auto const freq_it = word_freqs.find(guess);
-        double const freq = freq_it == word_freqs.end() ? 0.0 : freq_it->second;
-        std::tuple<double, bool, double> value{total_entropy, !std::ranges::binary_search(remaining_words, guess),
-                                               -freq};
+                         for (auto const& [guess, feedback] : history) {
+                             node = *view.child(node, feedback);
+                         }
 
-        if (value < objective) {
-            std::lock_guard<std::mutex> guard(result_mut);
+                         auto const solutions = strategy_solutions(view, node);
+                         double total = 0.0;
 
-            if (value < objective) {
-                result = guess;
-                objective = value;
-            }
+                         for (auto const& [word, guesses] : solutions) {
+                             total += guesses;
+                         }
+
+                         return std::pair{view.guess(node), total / solutions.size()};
+                     });
+    return 0;
+}
+
+void print_report(VerifyReport const& report, std::size_t const num_words, std::size_t const max_guesses) {
+    std::cout << "Solved " << report.solved << " of " << num_words << " words within " << max_guesses << " guesses.\n";
+
+    if (!report.failed_words.empty()) {
+        std::cout << "Not solved:";
+
+        for (Word const& w : report.failed_words | std::views::take(20)) {
+            std::cout << ' ' << w;
         }
-    });
 
-    return {result, std::get<0>(objective)};
+        std::cout << (report.failed_words.size() > 20 ? " ...\n" : "\n");
+    }
+
+    std::cout << "Words with hard mode violations: " << report.hard_mode_violations << ".\n";
+    std::cout << "Guess distribution:";
+
+    for (std::size_t i = 1; i <= max_guesses; ++i) {
+        std::cout << ' ' << i << ": " << report.guess_distribution[i];
+    }
+
+    std::cout << "\nTotal guesses " << report.total_guesses << ", expected guesses "
+              << static_cast<double>(report.total_guesses) / std::max<std::size_t>(report.solved, 1) << ".\n";
 }
 
-// Instantiation of best_choice assuming each word from "remainig_words" is equally likely.
-std::pair<Word, double> best_choice_avg(std::vector<Word> const& allowed_choices,
-                                        std::vector<Word> const& remaining_words,
-                                        std::unordered_map<Word, double> const& word_freqs = {}) {
-    auto [word, entropy] = best_choice(allowed_choices, remaining_words, word_freqs, std::plus<double>());
-    return {word, entropy / remaining_words.size()};
+int run_verify(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 4) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    bool const hard_mode = args.size() >= 3 && std::atoi(args[2]) > 0;
+    std::size_t const max_guesses = args.size() >= 4 ? std::max(std::atoi(args[3]), 1) : 6;
+
+    auto const st = std::chrono::high_resolution_clock::now();
+    LoadedStrategy const strategy{args[0]};
+    auto const lt = std::chrono::high_resolution_clock::now();
+    VerifyReport const report = verify_strategy(strategy.view(), word_list, max_guesses);
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    print_report(report, word_list.size(), max_guesses);
+    std::cout << "Loading took " << std::chrono::duration_cast<std::chrono::microseconds>(lt - st).count()
+              << " us, verification took " << std::chrono::duration_cast<std::chrono::microseconds>(ct - lt).count()
+              << " us.\n";
+
+    bool const valid = report.failed_words.empty() && (!hard_mode || report.hard_mode_violations == 0);
+    std::cout << (valid ? "Strategy is valid.\n" : "Strategy is NOT valid!\n");
+    return valid ? 0 : 1;
 }
 
-// Instantiation of best_choice assuming the correct word from "remainig_words" is chosen adversarially.
-std::pair<Word, double> best_choice_adv(std::vector<Word> const& allowed_choices,
-                                        std::vector<Word> const& remaining_words,
-                                        std::unordered_map<Word, double> const& word_freqs = {}) {
-    return best_choice(allowed_choices, remaining_words, word_freqs,
-                       [](double const x, double const y) { return std::max(x, y); });
+int run_fit(std::span<char const* const> const args) {
+    if (args.size() < 3 || args.size() > 6) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
+
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    SolverOptions const options = parse_solver_options(args.subspan(3));
+
+    // Simulate a game for every word by computing the full strategy.
+    auto const st = std::chrono::high_resolution_clock::now();
+    StrategyTree const tree =
+        build_strategy_tree(guess_list, word_list, options.freq_data, options.hard_mode, options.scoring);
+    std::vector<CostSample> const samples = collect_cost_samples(tree, word_list);
+    CostModel const model = fit_cost_model(samples);
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Fitted cost model to " << samples.size() << " game states, coefficients:";
+
+    for (double const c : model.coeffs) {
+        std::cout << ' ' << c;
+    }
+
+    std::cout << "\nRMS error " << cost_model_error(model, samples) << " (default model "
+              << cost_model_error(CostModel{}, samples) << ").\n";
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+              << " ms.\n";
+
+    DataSections sections = std::filesystem::exists(args[2]) ? load_data_file(args[2]) : DataSections{};
+    store_cost_model(sections, model);
+    save_data_file(sections, args[2]);
+    return 0;
 }
 
-std::vector<Word> load_word_list(std::string const& filename) {
-    std::vector<Word> result;
-    std::ifstream file{filename};
+// Settings of the lookahead for the suggestion cache, which the distributed lookahead shares since it gives the same
+// results.
+std::string lookahead_settings(bool const hard_mode, std::size_t const depth, std::size_t const width,
+                               CostModel const& model) {
+    std::ostringstream settings;
+    settings.precision(17);
+    settings << "lookahead hard=" << hard_mode << " depth=" << depth << " width=" << width << " model=";
+
+    for (double const c : model.coeffs) {
+        settings << c << ',';
+    }
 
-    while (file.good()) {
-        Word w;
-        file >> w;
-        file.ignore();
+    return settings.str();
+}
 
-        result.push_back(w);
+int run_lookahead(std::span<char const* const> const args) {
+    if (args.size() < 3 || args.size() > 7) {
+        std::cout << usage;
+        return 0;
     }
 
-    std::ranges::sort(result);
+    std::vector<Word> guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
 
-    return result;
+    std::vector<Word> word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    CostModel const model = load_cost_model(load_data_file(args[2]));
+    bool const hard_mode = args.size() >= 4 && std::atoi(args[3]) > 0;
+    std::size_t const depth = args.size() >= 5 ? std::max(std::atoi(args[4]), 1) : 2;
+    std::size_t const width = args.size() >= 6 ? std::max(std::atoi(args[5]), 1) : 8;
+    std::size_t const table_mib = args.size() >= 7 ? std::max(std::atoi(args[6]), 1) : 256;
+
+    SuggestionCache cache =
+        open_suggestion_cache(guess_list, word_list, {}, lookahead_settings(hard_mode, depth, width, model));
+    TranspositionTable table{table_mib << 20};
+    interactive_loop(
+        std::move(guess_list), std::move(word_list), hard_mode, "expected guesses",
+        [&](std::vector<Word> const& guesses, std::vector<Word> const& words) {
+            table.new_search();
+            auto const result = best_choice_lookahead(guesses, words, model, hard_mode, depth, width, table);
+            std::cout << "Transposition table: " << table.fill_rate() * 100.0 << "% of "
+                      << table.memory_usage() / (1 << 20) << " MiB filled, " << table.hits() << " of "
+                      << table.probes() << " probes hit, " << table.collisions() << " collisions.\n";
+            return result;
+        },
+        &cache);
+    return 0;
 }
 
-std::unordered_map<Word, double> load_freq_data(std::string const& filename) {
-    std::unordered_map<Word, double> result;
-    std::ifstream freq_data_file{filename};
+// Long lookahead search for the best opener that checkpoints its progress and can resume from the checkpoint.
+int run_search(std::span<char const* const> const args) {
+    if (args.size() < 4 || args.size() > 10) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
 
-    while (freq_data_file.good()) {
-        Word w;
-        double f;
-        freq_data_file >> w >> f;
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
 
-        result[w] = f;
+    CostModel const model = load_cost_model(load_data_file(args[2]));
+    bool const resume = args.size() >= 5 && std::atoi(args[4]) > 0;
+    bool const hard_mode = args.size() >= 6 && std::atoi(args[5]) > 0;
+    std::size_t const depth = args.size() >= 7 ? std::max(std::atoi(args[6]), 1) : 3;
+    std::size_t const width = args.size() >= 8 ? std::max(std::atoi(args[7]), 1) : 8;
+    std::chrono::seconds const interval{args.size() >= 9 ? std::max(std::atoi(args[8]), 1) : 60};
+    std::size_t const table_mib = args.size() >= 10 ? std::max(std::atoi(args[9]), 1) : 256;
+
+    TranspositionTable table{table_mib << 20};
+    std::uint64_t const fingerprint = lookahead_fingerprint(guess_list, word_list, model, hard_mode, depth, width);
+    SearchCheckpoint checkpoint{args[3], fingerprint, table, interval};
+
+    if (resume && checkpoint.resume()) {
+        std::cout << "Resumed " << checkpoint.num_finished() << " finished guesses, "
+                  << checkpoint.num_finished_buckets() << " finished buckets and " << table.stores()
+                  << " table entries from " << args[3] << "!\n";
+    } else if (resume) {
+        std::cout << "No checkpoint for these settings in " << args[3] << ", starting over!\n";
     }
 
-    return result;
+    auto const st = std::chrono::high_resolution_clock::now();
+    auto const [guess, cost] =
+        checkpointed_lookahead(checkpoint, guess_list, word_list, model, hard_mode, depth, width, table);
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Best guess is \"" << guess << "\" with expected guesses " << cost << ".\n";
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+              << " ms, " << checkpoint.num_writes() << " checkpoints written.\n";
+
+    if (std::string const error = checkpoint.last_error(); !error.empty()) {
+        std::cout << "Writing a checkpoint failed: " << error << '\n';
+    }
+
+    return 0;
 }
 
-int main(int const argc, char const* const* const argv) {
-    if (argc < 3 || argc > 6) {
-        std::cout << "Usage: ./wordle_solver guess_list.txt word_list.txt "
-                     "[hard mode = 0/1] [adversarial = 0/1] [freq_data.txt]\n";
+// Answers lookahead tasks from standard input until it is closed, see serve_lookahead_task. Standard output is the
+// channel to the coordinator, so nothing else is printed there.
+int run_worker(std::span<char const* const> const args) {
+    if (args.size() < 3 || args.size() > 7) {
+        std::cerr << usage;
+        return 1;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    CostModel const model = load_cost_model(load_data_file(args[2]));
+    bool const hard_mode = args.size() >= 4 && std::atoi(args[3]) > 0;
+    std::size_t const depth = args.size() >= 5 ? std::max(std::atoi(args[4]), 1) : 2;
+    std::size_t const width = args.size() >= 6 ? std::max(std::atoi(args[5]), 1) : 8;
+    std::size_t const table_mib = args.size() >= 7 ? std::max(std::atoi(args[6]), 1) : 256;
+    TranspositionTable table{table_mib << 20};
+    std::string task;
+
+    while (std::getline(std::cin, task)) {
+        std::cout << serve_lookahead_task(task, guess_list, word_list, model, hard_mode, depth, width, table)
+                  << std::endl;
+    }
+
+    return 0;
+}
+
+// Quotes an argument for /bin/sh.
+std::string shell_quote(std::string_view const arg) {
+    std::string result = "'";
+
+    for (char const c : arg) {
+        result += c == '\'' ? std::string{"'\\''"} : std::string{c};
+    }
+
+    return result + '\'';
+}
+
+// The lookahead with the guesses of every turn evaluated by worker processes. "workers" is either the number of local
+// workers or a file with one command per line that starts this program elsewhere (e.g. "ssh host wordle_solver"),
+// to which the worker arguments are appended.
+int run_distributed(std::span<char const* const> const args) {
+    if (args.size() < 4 || args.size() > 8) {
+        std::cout << usage;
         return 0;
     }
 
-    // Load guess list
-    std::vector<Word> guess_list = load_word_list(argv[1]);
+    std::vector<Word> guess_list = load_word_list(args[0]);
     std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
 
-    // Load list of possible correct words
-    std::vector<Word> word_list = load_word_list(argv[2]);
+    std::vector<Word> word_list = load_word_list(args[1]);
     std::cout << "Loaded word list with " << word_list.size() << " words!\n";
 
-    // Hard mode: only allow guesses that conform to previous information
-    bool const hard_mode = argc >= 4 && std::atoi(argv[3]) > 0;
-    // Adversarial: assume correct word is being changed adversarially
-    bool const adverserial = argc >= 5 && std::atoi(argv[4]) > 0;
+    CostModel const model = load_cost_model(load_data_file(args[2]));
+    bool const hard_mode = args.size() >= 5 && std::atoi(args[4]) > 0;
+    std::size_t const depth = args.size() >= 6 ? std::max(std::atoi(args[5]), 1) : 2;
+    std::size_t const width = args.size() >= 7 ? std::max(std::atoi(args[6]), 1) : 8;
+    std::chrono::seconds const timeout{args.size() >= 8 ? std::max(std::atoi(args[7]), 1) : 600};
+
+    std::vector<std::string> prefixes;
+
+    if (std::string_view{args[3]}.find_first_not_of("0123456789") == std::string_view::npos) {
+        std::string const self = shell_quote(std::filesystem::read_symlink("/proc/self/exe").string());
+        prefixes.assign(std::max(std::atoi(args[3]), 1), self);
+    } else {
+        std::ifstream file{args[3]};
+        std::string line;
+
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                prefixes.push_back(line);
+            }
+        }
+    }
+
+    std::string worker_args = " worker";
+
+    for (char const* const arg : {args[0], args[1], args[2]}) {
+        worker_args += ' ' + shell_quote(std::filesystem::absolute(arg).string());
+    }
+
+    worker_args += ' ' + std::to_string(hard_mode) + ' ' + std::to_string(depth) + ' ' + std::to_string(width);
+
+    std::vector<std::string> commands;
+
+    for (std::string const& prefix : prefixes) {
+        commands.push_back(prefix + worker_args);
+    }
+
+    WorkerPool pool{commands, 3, timeout};
+    std::cout << "Using " << commands.size() << " workers!\n";
+
+    SuggestionCache cache =
+        open_suggestion_cache(guess_list, word_list, {}, lookahead_settings(hard_mode, depth, width, model));
+    interactive_loop(
+        std::move(guess_list), std::move(word_list), hard_mode, "expected guesses",
+        [&](std::vector<Word> const& guesses, std::vector<Word> const& words,
+            std::vector<SuggestionCache::Turn> const& history) {
+            auto const result = distributed_lookahead(pool, history, guesses, words, model, hard_mode, depth, width);
+            std::cout << pool.num_workers() << " workers left, " << pool.num_failures() << " tasks retried so far.\n";
+            return result;
+        },
+        &cache);
+    return 0;
+}
+
+int run_mcts(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 4) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
+
+    std::vector<Word> word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    MctsOptions options;
+
+    if (args.size() >= 3) {
+        options.budget = std::chrono::milliseconds{std::max(std::atoi(args[2]), 1)};
+    }
 
-    // Load list of word frequency information for tie breaker
     std::unordered_map<Word, double> freq_data;
-    if (argc == 6) {
-        freq_data = load_freq_data(argv[5]);
+
+    if (args.size() >= 4) {
+        freq_data = load_freq_data(args[3]);
         std::cout << "Loaded word frequency data for " << freq_data.size() << " words!\n";
     }
 
-    while (true) {
+    interactive_loop(std::move(guess_list), std::move(word_list), false, "expected guesses",
+                     [&](std::vector<Word> const& guesses, std::vector<Word> const& words) {
+                         MctsNode root{words, guesses, options, true};
+                         MctsResult const result = mcts_search(root, guesses, freq_data, options);
+
+                         std::cout << "Ran " << result.rollouts << " rollouts, top guesses:\n";
+
+                         for (MctsEdge const* edge : result.ranking | std::views::take(10)) {
+                             std::cout << "  " << edge->guess << "  visits " << edge->visits << "  expected guesses "
+                                       << edge->total_cost / std::max<std::size_t>(edge->visits, 1) << "  prior "
+                                       << edge->prior << '\n';
+                         }
+
+                         MctsEdge const& best = *result.ranking.front();
+                         return std::pair{best.guess, best.total_cost / std::max<std::size_t>(best.visits, 1)};
+                     });
+    return 0;
+}
+
+int run_beam(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 5) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
+
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    std::size_t const length = args.size() >= 3 ? std::max(std::atoi(args[2]), 1) : 2;
+    std::size_t const width = args.size() >= 4 ? std::max(std::atoi(args[3]), 1) : 16;
+    Scoring const scoring = args.size() >= 5 ? parse_scoring(args[4]) : Scoring::entropy;
+
+    auto const st = std::chrono::high_resolution_clock::now();
+    std::vector<JointPartition> const beam = beam_search(guess_list, word_list, length, width, scoring);
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Best openers with " << length << " guesses by " << scoring_description(scoring) << ":\n";
+
+    for (JointPartition const& p : beam) {
+        std::cout << ' ';
+
+        for (Word const& w : p.guesses) {
+            std::cout << ' ' << w;
+        }
+
+        std::cout << "  " << p.score << " (" << p.num_classes << " classes)\n";
+    }
+
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+              << " ms.\n";
+    return 0;
+}
+
+int run_opener(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 1 + max_combined_guesses) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const word_list = load_word_list(args[0]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    std::vector<Word> opener(args.size() - 1);
+
+    for (std::size_t i = 0; i < opener.size(); ++i) {
+        opener[i] = parse_word(args[i + 1]);
+    }
+
+    auto const st = std::chrono::high_resolution_clock::now();
+    PatternMatrix const matrix{opener, word_list};
+    std::vector<std::span<Feedback const>> rows;
+
+    for (std::size_t i = 0; i < opener.size(); ++i) {
+        rows.push_back(matrix.row(i));
+    }
+
+    auto const histogram = combined_histogram(combined_codes(rows), opener.size());
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    std::size_t const singletons = std::ranges::count(histogram | std::views::values, 1u);
+    std::cout << "Opener splits the words into " << histogram.size() << " classes and identifies " << singletons
+              << " words uniquely.\n";
+
+    for (std::size_t i = 0; i < scoring_names.size(); ++i) {
+        SizeReduction reduction{static_cast<Scoring>(i)};
+
+        for (std::uint32_t const n : histogram | std::views::values) {
+            reduction.add(n);
+        }
+
+        std::cout << "  " << scoring_names[i].second << ": " << reduction.result(word_list.size()) << '\n';
+    }
+
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::microseconds>(ct - st).count()
+              << " us.\n";
+    return 0;
+}
+
+int run_multi(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 3) {
+        std::cout << usage;
+        return 0;
+    }
+
+    Dictionary dict{load_word_list(args[0]), load_word_list(args[1])};
+    std::cout << "Loaded guess list with " << dict.guesses.size() << " words!\n";
+    std::cout << "Loaded word list with " << dict.words.size() << " words!\n";
+    dict.second_moves = load_default_second_moves();
+
+    MultiGame game{dict, args.size() >= 3 ? static_cast<std::size_t>(std::max(std::atoi(args[2]), 1)) : 4};
+
+    while (!game.finished()) {
         auto const st = std::chrono::high_resolution_clock::now();
-        auto [guess, entropy] =
-            adverserial ? best_choice_adv(guess_list, word_list) : best_choice_avg(guess_list, word_list, freq_data);
+        auto const [guess, score] = game.suggest();
         auto const ct = std::chrono::high_resolution_clock::now();
 
-        std::cout << "Best guess is \"" << guess << "\" with " << (adverserial ? "maximum" : "average") << " entropy "
-                  << entropy << ".\n";
+        std::cout << "Best guess is \"" << guess << "\" with total average entropy " << score << ".\n";
         std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
                   << " ms.\n";
 
-        std::cout << "Response (b|y|g) * 5: ";
-        std::string info_string;
-        std::cin >> info_string;
+        std::vector<Feedback> feedback(game.num_boards(), all_green);
+
+        for (std::size_t b = 0; b < game.num_boards(); ++b) {
+            if (game.solved(b)) {
+                continue;
+            }
+
+            std::cout << "Response for board " << b + 1 << " (b|y|g) * 5: ";
+            std::string info_string;
+
+            if (!(std::cin >> info_string)) {
+                return 0;
+            }
+
+            try {
+                feedback[b] = parse_feedback(info_string);
+            } catch (std::invalid_argument const& e) {
+                std::cout << e.what() << '\n';
+                --b;
+            }
+        }
+
+        game.apply_feedback(guess, feedback);
 
-        if (info_string == "ggggg") {
-            break;
+        for (std::size_t b = 0; b < game.num_boards(); ++b) {
+            if (!game.solved(b) && game.candidates(b).size() < 10) {
+                std::cout << "Remaining words for board " << b + 1 << ':';
+                game.candidates(b).for_each([&](std::size_t const i) { std::cout << ' ' << dict.words[i]; });
+                std::cout << '\n';
+            }
         }
+    }
+
+    return 0;
+}
 
-        WordInfo const info{guess, info_string};
+int run_simulate(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 6) {
+        std::cout << usage;
+        return 0;
+    }
 
-        std::erase_if(word_list, [&](Word const w) { return !info.check_word(w); });
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
 
-        if (hard_mode) {
-            std::erase_if(guess_list, [&](Word const w) { return !info.check_word(w); });
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    // Spread a limited number of games evenly over the word list.
+    std::size_t const num_games = args.size() >= 3 && std::atoi(args[2]) > 0
+                                      ? std::min<std::size_t>(std::atoi(args[2]), word_list.size())
+                                      : word_list.size();
+    std::vector<Word> secrets;
+
+    for (std::size_t i = 0; i < num_games; ++i) {
+        secrets.push_back(word_list[i * word_list.size() / num_games]);
+    }
+
+    SolverOptions const options = parse_solver_options(args.subspan(std::min<std::size_t>(args.size(), 3)));
+
+    auto const st = std::chrono::high_resolution_clock::now();
+    VerifyReport const report = simulate_games(guess_list, word_list, secrets, options.freq_data, options.hard_mode,
+                                               options.scoring, 6);
+    auto const ct = std::chrono::high_resolution_clock::now();
+
+    print_report(report, secrets.size(), 6);
+    std::cout << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+              << " ms.\n";
+    return 0;
+}
+
+int run_second(std::span<char const* const> const args) {
+    if (args.size() < 3) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
+
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    // The best opener is always included, further openers are given by name. Hard mode and the objective are
+    // positional like in the other modes, the frequency data and the openers are named by flags.
+    std::vector<char const*> positional;
+    char const* freqs = nullptr;
+    std::vector<std::optional<Word>> openers{std::nullopt};
+
+    for (std::size_t i = 3; i < args.size(); ++i) {
+        std::string_view const arg = args[i];
+
+        if ((arg == "--freqs" || arg == "--opener") && i + 1 == args.size()) {
+            std::cout << usage;
+            return 0;
+        } else if (arg == "--freqs") {
+            freqs = args[++i];
+        } else if (arg == "--opener") {
+            openers.emplace_back(parse_word(args[++i]));
+        } else {
+            positional.push_back(args[i]);
         }
+    }
 
-        if (word_list.size() < 10) {
-            std::cout << "Remaining words:";
+    if (positional.size() > 2) {
+        std::cout << usage;
+        return 0;
+    }
 
-            for (Word const& w : word_list) {
-                std::cout << ' ' << w;
+    SolverOptions options = parse_solver_options(positional);
+
+    if (freqs) {
+        options.freq_data = load_freq_data(freqs);
+        std::cout << "Loaded word frequency data for " << options.freq_data.size() << " words!\n";
+    }
+
+    DataSections sections = std::filesystem::exists(args[2]) ? load_data_file(args[2]) : DataSections{};
+    std::vector<SecondMoveTable> tables = load_second_moves(sections);
+
+    for (std::optional<Word> const& opener : openers) {
+        auto const st = std::chrono::high_resolution_clock::now();
+        SecondMoveTable table = build_second_moves(guess_list, word_list, options.freq_data, options.hard_mode,
+                                                   options.scoring, opener);
+        auto const ct = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Computed second guesses for " << table.replies.size() << " responses to \"" << table.opener
+                  << "\" in " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count() << " ms.\n";
+
+        // Replaces an older table for the same opener and settings.
+        std::erase_if(tables, [&](SecondMoveTable const& t) {
+            return t.applies_to(table.fingerprint, table.hard_mode, table.scoring) && t.opener == table.opener;
+        });
+        tables.push_back(std::move(table));
+    }
+
+    store_second_moves(sections, tables);
+    save_data_file(sections, args[2]);
+    return 0;
+}
+
+// Streams recorded games (one per line) in batches that are analyzed in parallel and written as CSV in input order, so
+// memory stays bounded no matter how many games there are.
+int run_replay(std::span<char const* const> const args) {
+    if (args.size() < 4 || args.size() > 5) {
+        std::cout << usage;
+        return 0;
+    }
+
+    std::vector<Word> const guess_list = load_word_list(args[0]);
+    std::vector<Word> const word_list = load_word_list(args[1]);
+    bool const hard_mode = args.size() >= 5 && std::atoi(args[4]) > 0;
+
+    std::ifstream in_file;
+    std::ofstream out_file;
+
+    if (std::string_view{args[2]} != "-") {
+        in_file.open(args[2]);
+    }
+
+    if (std::string_view{args[3]} != "-") {
+        out_file.open(args[3]);
+    }
+
+    std::istream& in = in_file.is_open() ? in_file : std::cin;
+    std::ostream& out = out_file.is_open() ? out_file : std::cout;
+    std::ostream& log = out_file.is_open() ? std::cout : std::cerr;
+
+    // Shares the best guesses with the interactive loop in the same settings, including the second move tables.
+    std::string const settings = "best_choice hard=" + std::to_string(hard_mode) + " entropy";
+    SuggestionCache cache = open_suggestion_cache(guess_list, word_list, {}, settings, log);
+    std::uint64_t const fingerprint = search_fingerprint(guess_list, word_list);
+
+    for (SecondMoveTable const& table : load_default_second_moves(log)) {
+        if (table.applies_to(fingerprint, hard_mode, Scoring::entropy)) {
+            cache.remember(table);
+        }
+    }
+
+    GameReplayer replayer{guess_list, word_list, hard_mode, &cache};
+    constexpr std::size_t batch_size = 4096;
+    constexpr std::size_t max_trie_bytes = std::size_t{1} << 30;  // The trie starts over when it grows beyond this.
+    std::size_t max_nodes = 0;
+    std::vector<std::string> lines;
+    std::vector<std::optional<std::vector<MoveMetrics>>> results;
+    std::size_t line_number = 0;
+    std::size_t games = 0;
+    std::size_t moves = 0;
+    std::size_t skipped = 0;
+
+    out << "line,turn,guess,response,candidates,remaining,best_guess,chosen_bits,best_bits,actual_bits,skill,luck\n";
+    auto const st = std::chrono::high_resolution_clock::now();
+
+    while (in) {
+        lines.clear();
+
+        for (std::string line; lines.size() < batch_size && std::getline(in, line);) {
+            lines.push_back(std::move(line));
+        }
+
+        results.assign(lines.size(), std::nullopt);
+        std::transform(std::execution::par, lines.begin(), lines.end(), results.begin(), [&](std::string const& line) {
+            try {
+                return std::optional{replayer.replay(parse_recorded_game(line))};
+            } catch (std::invalid_argument const&) {
+                return std::optional<std::vector<MoveMetrics>>{};
             }
+        });
 
-            std::cout << '\n';
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            ++line_number;
+
+            if (!results[i] || results[i]->empty()) {
+                skipped += !results[i] || lines[i].find_first_not_of(" \t\r") != std::string::npos;
+                continue;
+            }
+
+            ++games;
+
+            for (std::size_t t = 0; t < results[i]->size(); ++t) {
+                MoveMetrics const& m = (*results[i])[t];
+                out << line_number << ',' << t + 1 << ',' << m.guess << ',' << feedback_string(m.feedback) << ','
+                    << m.candidates << ',' << m.remaining << ',' << m.best_guess << ',' << m.chosen_bits << ','
+                    << m.best_bits << ',' << m.actual_bits << ',' << m.skill() << ',' << m.luck() << '\n';
+                ++moves;
+            }
+        }
+
+        max_nodes = std::max(max_nodes, replayer.trie().num_nodes());
+
+        if (replayer.trie().memory_usage() > max_trie_bytes) {
+            replayer.trie().clear();
+        }
+    }
+
+    auto const ct = std::chrono::high_resolution_clock::now();
+    log << "Replayed " << games << " games with " << moves << " moves, skipped " << skipped << " invalid lines.\n";
+    log << "Best guesses: " << replayer.cache_misses() << " searched, " << replayer.cache_hits()
+        << " found without search (" << replayer.trie().num_transpositions() << " by transposition).\n";
+    log << "Game state trie: " << replayer.trie().num_nodes() << " nodes using "
+        << replayer.trie().memory_usage() / 1024 << " KiB (at most " << max_nodes << " nodes).\n";
+    log << "Computation took " << std::chrono::duration_cast<std::chrono::milliseconds>(ct - st).count()
+        << " ms.\n";
+    return 0;
+}
+
+int run_interactive(std::span<char const* const> const args) {
+    if (args.size() < 2 || args.size() > 5) {
+        std::cout << usage;
+        return 0;
+    }
+
+    // Load guess list
+    std::vector<Word> guess_list = load_word_list(args[0]);
+    std::cout << "Loaded guess list with " << guess_list.size() << " words!\n";
+
+    // Load list of possible correct words
+    std::vector<Word> word_list = load_word_list(args[1]);
+    std::cout << "Loaded word list with " << word_list.size() << " words!\n";
+
+    auto const [hard_mode, scoring, freq_data] = parse_solver_options(args.subspan(2));
+
+    std::string const settings = "best_choice hard=" + std::to_string(hard_mode) + ' ' +
+                                 std::string{scoring_names[static_cast<std::size_t>(scoring)].first};
+    SuggestionCache cache = open_suggestion_cache(guess_list, word_list, freq_data, settings);
+    std::uint64_t const fingerprint = search_fingerprint(guess_list, word_list, freq_data);
+
+    for (SecondMoveTable const& table : load_default_second_moves()) {
+        if (table.applies_to(fingerprint, hard_mode, scoring)) {
+            cache.remember(table);
         }
     }
+    interactive_loop(
+        std::move(guess_list), std::move(word_list), hard_mode, scoring_description(scoring),
+        [&](std::vector<Word> const& guesses, std::vector<Word> const& words) {
+            return best_choice(guesses, words, freq_data, scoring);
+        },
+        &cache);
+    return 0;
+}
+
+int main(int const argc, char const* const* const argv) {
+    std::span<char const* const> const args{argv + 1, static_cast<std::size_t>(std::max(argc - 1, 0))};
+    std::string_view const mode = args.empty() ? "" : args[0];
+
+    if (mode == "build") {
+        return run_build(args.subspan(1));
+    } else if (mode == "export") {
+        return run_export(args.subspan(1));
+    } else if (mode == "play") {
+        return run_play(args.subspan(1));
+    } else if (mode == "verify") {
+        return run_verify(args.subspan(1));
+    } else if (mode == "fit") {
+        return run_fit(args.subspan(1));
+    } else if (mode == "lookahead") {
+        return run_lookahead(args.subspan(1));
+    } else if (mode == "search") {
+        return run_search(args.subspan(1));
+    } else if (mode == "distributed") {
+        return run_distributed(args.subspan(1));
+    } else if (mode == "worker") {
+        return run_worker(args.subspan(1));
+    } else if (mode == "mcts") {
+        return run_mcts(args.subspan(1));
+    } else if (mode == "beam") {
+        return run_beam(args.subspan(1));
+    } else if (mode == "opener") {
+        return run_opener(args.subspan(1));
+    } else if (mode == "multi") {
+        return run_multi(args.subspan(1));
+    } else if (mode == "simulate") {
+        return run_simulate(args.subspan(1));
+    } else if (mode == "second") {
+        return run_second(args.subspan(1));
+    } else if (mode == "replay") {
+        return run_replay(args.subspan(1));
+    }
+
+    return run_interactive(args);
 }
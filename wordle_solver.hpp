@@ -0,0 +1,4066 @@
+#pragma once
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// On x86 the AVX2 kernels are compiled for every build and chosen at runtime, see has_avx2.
+#if defined(__x86_64__) || defined(__i386__)
+#define WORDLE_SOLVER_X86
+#include <immintrin.h>
+#endif
+
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using Word = std::array<char, 5>;
+
+inline std::ostream& operator<<(std::ostream& os, Word const& w) {
+    for (char const c : w) {
+        os << static_cast<char>(c + 'a');
+    }
+
+    return os;
+}
+
+inline std::istream& operator>>(std::istream& is, Word& w) {
+    for (char& c : w) {
+        if (!(is >> c)) {
+            return is;
+        }
+
+        if (c < 'a' || c > 'z') {
+            throw std::invalid_argument("Tried to read in word with letter outside of a-z range!");
+        }
+
+        c -= 'a';
+    }
+
+    return is;
+}
+
+// Whether "s" is a word that parse_word accepts.
+inline bool is_word(std::string_view const s) {
+    return s.size() == 5 && std::ranges::all_of(s, [](char const c) { return c >= 'a' && c <= 'z'; });
+}
+
+inline Word parse_word(std::string_view const s) {
+    if (s.size() != 5) {
+        throw std::invalid_argument("Words must consist of exactly 5 letters!");
+    }
+
+    Word result;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        if (s[i] < 'a' || s[i] > 'z') {
+            throw std::invalid_argument("Tried to read in word with letter outside of a-z range!");
+        }
+
+        result[i] = static_cast<char>(s[i] - 'a');
+    }
+
+    return result;
+}
+
+// This represents the information that was obtained from "guess". Instead of storing the colored squares, we use a
+// representation which allows us to test whether another word matches this information very efficiently.
+struct WordInfo {
+    Word guess;
+    std::array<bool, 5> correct_letters;
+    std::array<char, 26> min_counts;
+    std::array<char, 26> max_counts;
+
+    WordInfo(Word const guess, Word const truth) : guess{guess} {
+        for (std::size_t i = 0; i < 5; ++i) {
+            correct_letters[i] = (guess[i] == truth[i]);
+        }
+
+        std::array<char, 26> guess_counts{0};
+        std::array<char, 26> truth_counts{0};
+
+        for (char const c : guess) {
+            ++guess_counts[c];
+        }
+
+        for (char const c : truth) {
+            ++truth_counts[c];
+        }
+
+        for (std::size_t i = 0; i < 26; ++i) {
+            if (guess_counts[i] <= truth_counts[i]) {
+                min_counts[i] = guess_counts[i];
+                max_counts[i] = 5;
+            } else {
+                min_counts[i] = truth_counts[i];
+                max_counts[i] = truth_counts[i];
+            }
+        }
+    }
+
+    WordInfo(Word const guess, std::string const& info) : guess{guess}, min_counts{} {
+        std::ranges::fill(max_counts, 5);
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            if (info[i] == 'g') {
+                correct_letters[i] = true;
+                ++min_counts[guess[i]];
+                continue;
+            }
+
+            correct_letters[i] = false;
+
+            if (info[i] == 'y') {
+                ++min_counts[guess[i]];
+            }
+        }
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            if (info[i] == 'b') {
+                max_counts[guess[i]] = min_counts[guess[i]];
+            }
+        }
+    }
+
+    bool check_word(Word const word) const {
+        std::array<char, 26> counts{0};
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            if ((word[i] == guess[i]) != correct_letters[i]) {
+                return false;
+            }
+
+            if (++counts[word[i]] > max_counts[word[i]]) {
+                return false;
+            }
+        }
+
+        return std::ranges::all_of(guess, [&](char const c) { return counts[c] >= min_counts[c]; });
+    }
+
+    bool operator==(WordInfo const& other) const = default;
+};
+
+// Words in structure of arrays layout: the letters at each position are stored contiguously and padded to a multiple
+// of packed_block words, so that the filter kernels check a constraint for a whole block of words at once.
+constexpr std::size_t packed_block = 32;
+
+class PackedWords {
+public:
+    explicit PackedWords(std::span<Word const> const words)
+        : size_{words.size()}, num_blocks_{(words.size() + packed_block - 1) / packed_block},
+          letters_(5 * num_blocks_ * packed_block) {
+        std::size_t const stride = num_blocks_ * packed_block;
+
+        for (std::size_t w = 0; w < size_; ++w) {
+            for (std::size_t i = 0; i < 5; ++i) {
+                letters_[i * stride + w] = static_cast<std::uint8_t>(words[w][i]);
+            }
+        }
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t num_blocks() const {
+        return num_blocks_;
+    }
+
+    std::uint8_t const* position(std::size_t const i) const {
+        return letters_.data() + i * num_blocks_ * packed_block;
+    }
+
+private:
+    std::size_t size_;
+    std::size_t num_blocks_;
+    std::vector<std::uint8_t> letters_;
+};
+
+// The constraints of a WordInfo as the filter kernels check them. A word passes check_word exactly if it has the
+// guessed letter at the green positions only and every guessed letter occurs within its bounds, since other letters
+// are not constrained.
+struct LetterBounds {
+    Word guess;
+    std::array<bool, 5> correct_letters;
+    std::size_t num_letters = 0;
+    std::array<std::uint8_t, 5> letters;
+    std::array<std::uint8_t, 5> min_counts;
+    std::array<std::uint8_t, 5> max_counts;
+
+    explicit LetterBounds(WordInfo const& info) : guess{info.guess}, correct_letters{info.correct_letters} {
+        for (char const c : info.guess) {
+            if (std::find(letters.begin(), letters.begin() + num_letters, c) == letters.begin() + num_letters) {
+                letters[num_letters] = static_cast<std::uint8_t>(c);
+                min_counts[num_letters] = static_cast<std::uint8_t>(info.min_counts[c]);
+                max_counts[num_letters] = static_cast<std::uint8_t>(info.max_counts[c]);
+                ++num_letters;
+            }
+        }
+    }
+};
+
+// Result of a filter kernel: bit w % 32 of entry w / 32 is set if word w is consistent with the constraint.
+using FilterMask = std::vector<std::uint32_t>;
+
+// Clears the bits of the padding after the last word.
+inline void clear_padding(PackedWords const& words, FilterMask& mask) {
+    if (std::size_t const rest = words.size() % packed_block; rest != 0) {
+        mask.back() &= (std::uint32_t{1} << rest) - 1;
+    }
+}
+
+// Portable kernel working on eight words at a time in 64 bit integers (SWAR), one byte per word. All per byte values
+// stay below 0x80, so the byte wise comparisons below never carry into the neighboring byte.
+constexpr std::uint64_t swar_ones = 0x0101010101010101ull;
+constexpr std::uint64_t swar_high_bits = 0x8080808080808080ull;
+
+// 1 in the bytes where x and y are equal, 0 in the others.
+inline std::uint64_t swar_equal_bytes(std::uint64_t const x, std::uint64_t const y) {
+    std::uint64_t const v = x ^ y;
+    return ~(((v & ~swar_high_bits) + ~swar_high_bits) | v | ~swar_high_bits) >> 7;
+}
+
+// 1 in the bytes where lo <= x <= hi, 0 in the others.
+inline std::uint64_t swar_bytes_between(std::uint64_t const x, std::uint8_t const lo, std::uint8_t const hi) {
+    return ((x + (0x80 - lo) * swar_ones) & ((0x80 + hi) * swar_ones - x) & swar_high_bits) >> 7;
+}
+
+// Gathers the lowest bits of the eight bytes into one byte.
+inline std::uint32_t swar_byte_mask(std::uint64_t const x) {
+    return static_cast<std::uint32_t>((x * 0x0102040810204080ull) >> 56);
+}
+
+inline FilterMask filter_mask_scalar(PackedWords const& words, WordInfo const& info) {
+    LetterBounds const bounds{info};
+    FilterMask result(words.num_blocks());
+
+    for (std::size_t b = 0; b < words.num_blocks(); ++b) {
+        std::uint32_t bits = 0;
+
+        for (std::size_t q = 0; q < packed_block; q += 8) {
+            std::array<std::uint64_t, 5> letters;
+            std::uint64_t ok = swar_ones;
+
+            for (std::size_t i = 0; i < 5; ++i) {
+                std::memcpy(&letters[i], words.position(i) + b * packed_block + q, sizeof(std::uint64_t));
+                std::uint64_t const green = swar_equal_bytes(letters[i], bounds.guess[i] * swar_ones);
+                ok &= bounds.correct_letters[i] ? green : green ^ swar_ones;
+            }
+
+            for (std::size_t k = 0; k < bounds.num_letters; ++k) {
+                std::uint64_t count = 0;
+
+                for (std::size_t i = 0; i < 5; ++i) {
+                    count += swar_equal_bytes(letters[i], bounds.letters[k] * swar_ones);
+                }
+
+                ok &= swar_bytes_between(count, bounds.min_counts[k], bounds.max_counts[k]);
+            }
+
+            bits |= swar_byte_mask(ok) << q;
+        }
+
+        result[b] = bits;
+    }
+
+    clear_padding(words, result);
+    return result;
+}
+
+// Whether the CPU running this supports AVX2, known at compile time if the whole build targets it.
+inline bool has_avx2() {
+#if defined(__AVX2__)
+    return true;
+#elif defined(WORDLE_SOLVER_X86)
+    static bool const result = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return result;
+#else
+    return false;
+#endif
+}
+
+#if defined(WORDLE_SOLVER_X86)
+// Checks 32 words per register: a byte compare per position gives the green mask, and letter counts are sums of the
+// compare results (which are -1 for equal bytes) over the positions. Compiled for AVX2 regardless of the build flags,
+// so it must only be called if has_avx2().
+__attribute__((target("avx2"))) inline FilterMask filter_mask_avx2(PackedWords const& words, WordInfo const& info) {
+    LetterBounds const bounds{info};
+    FilterMask result(words.num_blocks());
+    __m256i const all = _mm256_set1_epi8(-1);
+
+    for (std::size_t b = 0; b < words.num_blocks(); ++b) {
+        __m256i letters[5];
+        __m256i ok = all;
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            letters[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words.position(i) + b * packed_block));
+            __m256i const green = _mm256_cmpeq_epi8(letters[i], _mm256_set1_epi8(bounds.guess[i]));
+            ok = bounds.correct_letters[i] ? _mm256_and_si256(ok, green) : _mm256_andnot_si256(green, ok);
+        }
+
+        for (std::size_t k = 0; k < bounds.num_letters; ++k) {
+            __m256i const letter = _mm256_set1_epi8(static_cast<char>(bounds.letters[k]));
+            __m256i count = _mm256_setzero_si256();
+
+            for (std::size_t i = 0; i < 5; ++i) {
+                count = _mm256_sub_epi8(count, _mm256_cmpeq_epi8(letters[i], letter));
+            }
+
+            __m256i const too_few = _mm256_cmpgt_epi8(_mm256_set1_epi8(bounds.min_counts[k]), count);
+            __m256i const too_many = _mm256_cmpgt_epi8(count, _mm256_set1_epi8(bounds.max_counts[k]));
+            ok = _mm256_andnot_si256(_mm256_or_si256(too_few, too_many), ok);
+        }
+
+        result[b] = static_cast<std::uint32_t>(_mm256_movemask_epi8(ok));
+    }
+
+    clear_padding(words, result);
+    return result;
+}
+#endif
+
+inline FilterMask filter_mask(PackedWords const& words, WordInfo const& info) {
+#if defined(WORDLE_SOLVER_X86)
+    if (has_avx2()) {
+        return filter_mask_avx2(words, info);
+    }
+#endif
+
+    return filter_mask_scalar(words, info);
+}
+
+inline bool in_mask(FilterMask const& mask, std::size_t const w) {
+    return (mask[w / packed_block] >> (w % packed_block)) & 1;
+}
+
+// The words that are consistent with the information, in their original order, found by packing the words and running
+// the filter kernel on them.
+inline std::vector<Word> filter_words_packed(std::vector<Word> const& words, WordInfo const& info) {
+    FilterMask const mask = filter_mask(PackedWords{words}, info);
+    std::vector<Word> result;
+
+    for (std::size_t b = 0; b < mask.size(); ++b) {
+        for (std::uint32_t bits = mask[b]; bits != 0; bits &= bits - 1) {
+            result.push_back(words[b * packed_block + std::countr_zero(bits)]);
+        }
+    }
+
+    return result;
+}
+
+// Like filter_words_packed. Without AVX2 the portable kernel only breaks even with check_word, so packing the list
+// first would just add its cost.
+inline std::vector<Word> filter_words(std::vector<Word> const& words, WordInfo const& info) {
+    if (has_avx2()) {
+        return filter_words_packed(words, info);
+    }
+
+    std::vector<Word> result;
+    std::ranges::copy_if(words, std::back_inserter(result), [&](Word const w) { return info.check_word(w); });
+    return result;
+}
+
+// Compact encoding of the colored squares: one base 3 digit per position (0 = gray, 1 = yellow, 2 = green) with the
+// first letter as the least significant digit. Two truths are indistinguishable by "guess" exactly if they produce the
+// same code, so this carries the same information as WordInfo{guess, truth} while fitting into a single byte.
+using Feedback = std::uint8_t;
+
+constexpr std::size_t num_feedbacks = 243;
+constexpr Feedback all_green = 242;
+constexpr std::array<Feedback, 5> feedback_digits{1, 3, 9, 27, 81};
+
+inline Feedback feedback_code(Word const guess, Word const truth) {
+    std::array<char, 26> unmatched{0};
+    Feedback code = 0;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        if (guess[i] == truth[i]) {
+            code += 2 * feedback_digits[i];
+        } else {
+            ++unmatched[truth[i]];
+        }
+    }
+
+    // Yellow squares are handed out left to right as long as there are unmatched copies of the letter left in truth.
+    for (std::size_t i = 0; i < 5; ++i) {
+        if (guess[i] != truth[i] && unmatched[guess[i]] > 0) {
+            --unmatched[guess[i]];
+            code += feedback_digits[i];
+        }
+    }
+
+    return code;
+}
+
+inline std::string feedback_string(Feedback code) {
+    std::string result(5, 'b');
+
+    for (char& c : result) {
+        c = "byg"[code % 3];
+        code /= 3;
+    }
+
+    return result;
+}
+
+inline Feedback parse_feedback(std::string const& info) {
+    if (info.size() != 5) {
+        throw std::invalid_argument("Feedback must consist of exactly 5 letters!");
+    }
+
+    Feedback code = 0;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        switch (std::tolower(static_cast<unsigned char>(info[i]))) {
+            case 'b': break;
+            case 'y': code += feedback_digits[i]; break;
+            case 'g': code += 2 * feedback_digits[i]; break;
+            default: throw std::invalid_argument("Tried to read in feedback with letter other than b, y or g!");
+        }
+    }
+
+    return code;
+}
+
+template <>
+struct std::hash<Word> {
+    std::size_t operator()(Word const& word) const noexcept {
+        std::size_t h1 = 0;
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            h1 += static_cast<std::size_t>(word[i]) << (i * 8);
+        }
+
+        return std::hash<std::size_t>()(h1);
+    }
+};
+
+// Number of remaining words that produce each response for a fixed guess, i.e. the partition induced by the guess.
+using Histogram = std::array<std::uint32_t, num_feedbacks>;
+
+// Kernels that add precomputed feedback codes to a histogram. Incrementing a single histogram stalls on the store to
+// load forwarding of a counter whenever nearby codes are equal, which is common once only a few buckets are left, so
+// the interleaved kernel spreads the codes round robin over several sub-histograms that are summed at the end.
+inline void add_codes_scalar(std::span<Feedback const> const codes, Histogram& result) {
+    for (Feedback const f : codes) {
+        ++result[f];
+    }
+}
+
+constexpr std::size_t histogram_lanes = 4;
+
+inline void add_codes_interleaved(std::span<Feedback const> const codes, Histogram& result) {
+    std::array<std::array<std::uint32_t, num_feedbacks>, histogram_lanes> lanes{};
+    std::size_t i = 0;
+
+    for (; i + histogram_lanes <= codes.size(); i += histogram_lanes) {
+        for (std::size_t l = 0; l < histogram_lanes; ++l) {
+            ++lanes[l][codes[i + l]];
+        }
+    }
+
+    add_codes_scalar(codes.subspan(i), lanes[0]);
+
+    for (std::size_t f = 0; f < num_feedbacks; ++f) {
+        for (std::size_t l = 0; l < histogram_lanes; ++l) {
+            result[f] += lanes[l][f];
+        }
+    }
+}
+
+// Whether the CPU running this supports the AVX-512 subsets of add_codes_avx512, like has_avx2.
+inline bool has_avx512() {
+#if defined(__AVX512F__) && defined(__AVX512CD__) && defined(__AVX512BW__)
+    return true;
+#elif defined(WORDLE_SOLVER_X86)
+    static bool const result = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+               __builtin_cpu_supports("avx512bw");
+    }();
+    return result;
+#else
+    return false;
+#endif
+}
+
+#if defined(WORDLE_SOLVER_X86)
+// GCC 12 reports the undefined vectors that its own avx512fintrin.h uses as pass-through operands of the intrinsics
+// below as possibly uninitialized, a false positive in the header.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// Adds 16 codes at a time with a gather and a scatter. Equal codes within a vector are resolved by conflict detection:
+// every lane adds one plus the number of earlier lanes with the same code, and since scatters to the same address are
+// written in lane order the last such lane, which holds the full count, wins. Compiled for AVX-512 regardless of the
+// build flags, so it must only be called if has_avx512().
+__attribute__((target("avx512f,avx512cd,avx512bw"))) inline void add_codes_avx512(std::span<Feedback const> const codes,
+                                                                                   Histogram& result) {
+    // Popcount of every nibble, the conflict masks have at most 16 bits so two bytes per lane suffice.
+    __m512i const nibble_popcount = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+    __m512i const low_nibbles = _mm512_set1_epi8(0x0f);
+    __m512i const low_byte = _mm512_set1_epi32(0xff);
+    __m512i const ones = _mm512_set1_epi32(1);
+    auto* const counters = reinterpret_cast<int*>(result.data());
+    std::size_t i = 0;
+
+    for (; i + 16 <= codes.size(); i += 16) {
+        __m512i const idx = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(codes.data() + i)));
+        __m512i const conflicts = _mm512_conflict_epi32(idx);
+        __m512i const bytes = _mm512_add_epi8(
+            _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(conflicts, low_nibbles)),
+            _mm512_shuffle_epi8(nibble_popcount, _mm512_and_si512(_mm512_srli_epi32(conflicts, 4), low_nibbles)));
+        __m512i const earlier = _mm512_and_si512(_mm512_add_epi32(bytes, _mm512_srli_epi32(bytes, 8)), low_byte);
+        __m512i const counts = _mm512_i32gather_epi32(idx, counters, 4);
+        _mm512_i32scatter_epi32(counters, idx, _mm512_add_epi32(counts, _mm512_add_epi32(earlier, ones)), 4);
+    }
+
+    add_codes_scalar(codes.subspan(i), result);
+}
+
+#pragma GCC diagnostic pop
+#endif
+
+// Dispatches to the fastest kernel for the number of codes, the interleaved one only pays off once the codes outnumber
+// the counters it has to clear and sum. add_codes_avx512 is not among them: it was no faster than the scalar kernel on
+// short rows and slower than the interleaved one on long rows (see the benchmark).
+inline void add_codes(std::span<Feedback const> const codes, Histogram& result) {
+    if (codes.size() >= 4 * num_feedbacks) {
+        add_codes_interleaved(codes, result);
+    } else {
+        add_codes_scalar(codes, result);
+    }
+}
+
+// The codes of the guess are computed into a buffer first, the row of the pattern matrix that the guess would have, so
+// that they are counted by add_codes instead of incrementing the histogram in the same loop.
+inline Histogram feedback_histogram(Word const guess, std::vector<Word> const& words) {
+    thread_local std::vector<Feedback> codes;
+    codes.resize(words.size());
+    std::ranges::transform(words, codes.begin(), [&](Word const truth) { return feedback_code(guess, truth); });
+
+    Histogram result{0};
+    add_codes(codes, result);
+    return result;
+}
+
+// Feedback for every pair of guess and word, stored row by row so that all responses to one guess are contiguous.
+// Searches that look at the same words many times can use this instead of recomputing feedback codes.
+class PatternMatrix {
+public:
+    PatternMatrix(std::vector<Word> const& guesses, std::vector<Word> const& words)
+        : num_words_{words.size()}, codes_(guesses.size() * words.size()) {
+        std::for_each(std::execution::par_unseq, guesses.begin(), guesses.end(), [&](Word const& guess) {
+            std::size_t const g = &guess - guesses.data();
+
+            for (std::size_t w = 0; w < words.size(); ++w) {
+                codes_[g * num_words_ + w] = feedback_code(guess, words[w]);
+            }
+        });
+    }
+
+    std::span<Feedback const> row(std::size_t const guess) const {
+        return {codes_.data() + guess * num_words_, num_words_};
+    }
+
+    std::size_t num_words() const {
+        return num_words_;
+    }
+
+private:
+    std::size_t num_words_;
+    std::vector<Feedback> codes_;
+};
+
+// Combined feedback of a word for a sequence of up to 8 guesses, as the base 243 number with the response to the first
+// guess as the least significant digit. Words with equal combined codes cannot be told apart by the sequence.
+using CombinedCode = std::uint64_t;
+
+constexpr std::size_t max_combined_guesses = 8;  // 243^8 < 2^64
+
+// Combined codes of all words for the given pattern matrix rows.
+inline std::vector<CombinedCode> combined_codes(std::span<std::span<Feedback const> const> const rows) {
+    if (rows.size() > max_combined_guesses) {
+        throw std::invalid_argument("Combined codes support at most 8 guesses!");
+    }
+
+    std::vector<CombinedCode> result(rows.empty() ? 0 : rows.front().size(), 0);
+
+    for (auto const& row : rows | std::views::reverse) {
+        for (std::size_t w = 0; w < result.size(); ++w) {
+            result[w] = result[w] * num_feedbacks + row[w];
+        }
+    }
+
+    return result;
+}
+
+// Number of words for every distinct combined code, sorted by code. The codes are radix sorted on only those bytes
+// that can be nonzero for "num_guesses" guesses, after which equal codes are adjacent.
+inline std::vector<std::pair<CombinedCode, std::uint32_t>> combined_histogram(std::vector<CombinedCode> codes,
+                                                                              std::size_t const num_guesses) {
+    std::size_t const num_bytes = (static_cast<std::size_t>(std::ceil(num_guesses * std::log2(num_feedbacks))) + 7) / 8;
+    std::vector<CombinedCode> buffer(codes.size());
+
+    for (std::size_t byte = 0; byte < num_bytes; ++byte) {
+        std::array<std::size_t, 257> offsets{0};
+
+        for (CombinedCode const c : codes) {
+            ++offsets[((c >> (byte * 8)) & 255) + 1];
+        }
+
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        for (CombinedCode const c : codes) {
+            buffer[offsets[(c >> (byte * 8)) & 255]++] = c;
+        }
+
+        codes.swap(buffer);
+    }
+
+    std::vector<std::pair<CombinedCode, std::uint32_t>> result;
+
+    for (CombinedCode const c : codes) {
+        if (result.empty() || result.back().first != c) {
+            result.emplace_back(c, 0);
+        }
+
+        ++result.back().second;
+    }
+
+    return result;
+}
+
+// An objective scores the histogram of a guess given the total number of remaining words, smaller scores are better.
+// Objectives see the whole histogram rather than one bucket at a time so they are free to reduce it however is fastest.
+template <typename Fn>
+concept Objective = requires(Fn&& f, Histogram const& h, std::size_t n) {
+    { std::invoke(f, h, n) } -> std::convertible_to<double>;
+};
+
+// Average entropy (i.e. log_2(size)) of the remaining words after the guess, assuming each word is equally likely.
+struct EntropyObjective {
+    double operator()(Histogram const& h, std::size_t const n) const {
+        double result = 0.0;
+
+        for (std::uint32_t const c : h) {
+            result += c > 1 ? c * std::log2(c) : 0.0;
+        }
+
+        return result / n;
+    }
+};
+
+// log_2(n) in fixed point with 32 fractional bits, as the sum of the rounded logarithms of the prime factors of n.
+// Since the logarithms of primes are linearly independent, sums of n * log_2(n) that are equal in exact arithmetic
+// (such as 6 log 6 = 6 + 2 * 3 log 3) then also produce equal integers.
+constexpr int fixed_log2_bits = 32;
+
+inline std::uint64_t fixed_log2(std::uint32_t n) {
+    auto const prime_log2 = [](std::uint32_t const p) {
+        return static_cast<std::uint64_t>(std::llround(std::ldexp(std::log2(p), fixed_log2_bits)));
+    };
+
+    std::uint64_t result = 0;
+
+    for (std::uint32_t p = 2; p * p <= n; ++p) {
+        for (; n % p == 0; n /= p) {
+            result += prime_log2(p);
+        }
+    }
+
+    return n > 1 ? result + prime_log2(n) : result;
+}
+
+// n * fixed_log2(n) for all bucket sizes that the shipped word lists can produce.
+inline std::span<std::uint64_t const> fixed_nlogn_table() {
+    static std::vector<std::uint64_t> const table = [] {
+        std::vector<std::uint64_t> result(1 << 15);
+
+        for (std::uint32_t n = 0; n < result.size(); ++n) {
+            result[n] = n * fixed_log2(n);
+        }
+
+        return result;
+    }();
+
+    return table;
+}
+
+// EntropyObjective accumulated in integers, which makes the result independent of the order of summation and ties
+// exact. The error is below 2^-33 * log_2(n) after the division by n, so this ranks guesses like the floating point
+// version unless two of them are closer than that without being equal. The tests check that the rankings agree for the
+// shipped lists. With fewer than 2^16 remaining words the sums stay below 2^53 and convert to double exactly, and
+// the correctly rounded division by n preserves their order.
+struct FixedEntropyObjective {
+    std::uint64_t sum(Histogram const& h) const {
+        std::span<std::uint64_t const> const table = fixed_nlogn_table();
+        std::uint64_t result = 0;
+
+        for (std::uint32_t const c : h) {
+            result += c < table.size() ? table[c] : c * fixed_log2(c);
+        }
+
+        return result;
+    }
+
+    double operator()(Histogram const& h, std::size_t const n) const {
+        return std::ldexp(static_cast<double>(sum(h)), -fixed_log2_bits) / n;
+    }
+};
+
+// Maximum entropy of the remaining words after the guess, assuming the correct word is chosen adversarially.
+struct AdversarialObjective {
+    double operator()(Histogram const& h, std::size_t) const {
+        return std::log2(std::ranges::max(h));
+    }
+};
+
+// Expected number of words that remain after the guess.
+struct RemainingObjective {
+    double operator()(Histogram const& h, std::size_t const n) const {
+        double result = 0.0;
+
+        for (std::uint32_t const c : h) {
+            result += static_cast<double>(c) * c;
+        }
+
+        return result / n;
+    }
+};
+
+// Probability of *not* being done after the next turn if that turn guesses one of the remaining words, which is
+// 1 - (number of responses) / n since every response leaves a 1 / size chance.
+struct SolveNextObjective {
+    double operator()(Histogram const& h, std::size_t const n) const {
+        return 1.0 - static_cast<double>(std::ranges::count_if(h, [](std::uint32_t const c) { return c > 0; })) / n;
+    }
+};
+
+// Estimate of the number of guesses still needed to find one of n remaining words (counting the guess that finds it),
+// fitted as a quadratic in log_2(n) to games played by the entropy strategy.
+struct GuessCurve {
+    std::array<double, 3> coeffs{1.215, 0.293, -0.00825};
+
+    double operator()(std::size_t const n) const {
+        if (n <= 1) {
+            return n;
+        }
+
+        double const x = std::log2(n);
+        return coeffs[0] + x * (coeffs[1] + x * coeffs[2]);
+    }
+};
+
+// Expected number of guesses after this one, according to the guess curve. The all green bucket needs no more guesses.
+struct ExpectedGuessesObjective {
+    GuessCurve curve;
+
+    double operator()(Histogram const& h, std::size_t const n) const {
+        double result = 0.0;
+
+        for (std::size_t f = 0; f < all_green; ++f) {
+            result += h[f] > 0 ? h[f] * curve(h[f]) : 0.0;
+        }
+
+        return result / n;
+    }
+};
+
+// Size of the largest bucket, the integer counterpart of AdversarialObjective.
+struct MaxBucketObjective {
+    double operator()(Histogram const& h, std::size_t) const {
+        return std::ranges::max(h);
+    }
+};
+
+// Main function: determine the best word from "allowed_choices" given that we know that only "remaining_words" are
+// possible solutions. Ties are broken based on how common we think certain words are ("word_freqs"). The "best" choice
+// is the one that minimizes "fn" on the partition of the remaining words, e.g. the average entropy (random choice) or
+// the maximum entropy (adversarial choice).
+template <typename Fn>
+std::pair<Word, double> best_choice(std::vector<Word> const& allowed_choices, std::vector<Word> const& remaining_words,
+                                    std::unordered_map<Word, double> const& word_freqs,
+                                    Fn&& fn) requires Objective<Fn> {
+    Word result = allowed_choices.front();
+    // The largest double rather than infinity, which -Ofast assumes never occurs.
+    std::tuple<double, bool, double> objective{std::numeric_limits<double>::max(), true, 0.0};
+    std::mutex result_mut;
+
+    // We use std parallelization for free performance! Note that we cannot use std::execution::par_unseq because we use
+    // a mutex!
+    std::for_each(std::execution::par, allowed_choices.begin(), allowed_choices.end(), [&](Word const& guess) {
+        double const score = std::invoke(fn, feedback_histogram(guess, remaining_words), remaining_words.size());
+
+        if (score > std::get<0>(objective)) {
+            return;
+        }
+
+        // Tiebreakers
+        auto const freq_it = word_freqs.find(guess);
+        double const freq = freq_it == word_freqs.end() ? 0.0 : freq_it->second;
+        std::tuple<double, bool, double> value{score, !std::ranges::binary_search(remaining_words, guess), -freq};
+
+        if (value < objective) {
+            std::lock_guard<std::mutex> guard(result_mut);
+
+            if (value < objective) {
+                result = guess;
+                objective = value;
+            }
+        }
+    });
+
+    return {result, std::get<0>(objective)};
+}
+
+// Instantiation of best_choice assuming each word from "remainig_words" is equally likely.
+inline std::pair<Word, double> best_choice_avg(std::vector<Word> const& allowed_choices,
+                                               std::vector<Word> const& remaining_words,
+                                               std::unordered_map<Word, double> const& word_freqs = {}) {
+    return best_choice(allowed_choices, remaining_words, word_freqs, EntropyObjective{});
+}
+
+// Instantiation of best_choice assuming the correct word from "remainig_words" is chosen adversarially.
+inline std::pair<Word, double> best_choice_adv(std::vector<Word> const& allowed_choices,
+                                               std::vector<Word> const& remaining_words,
+                                               std::unordered_map<Word, double> const& word_freqs = {}) {
+    return best_choice(allowed_choices, remaining_words, word_freqs, AdversarialObjective{});
+}
+
+// Objectives that can be selected at runtime.
+enum class Scoring { entropy, adversarial, remaining, solve_next, expected_guesses, max_bucket, fixed_entropy };
+
+constexpr std::array<std::pair<std::string_view, std::string_view>, 7> scoring_names{{
+    {"entropy", "average entropy"},
+    {"adversarial", "maximum entropy"},
+    {"remaining", "expected remaining words"},
+    {"solve_next", "probability of not solving next turn"},
+    {"expected_guesses", "expected further guesses"},
+    {"max_bucket", "maximum remaining words"},
+    {"fixed_entropy", "average entropy (fixed point)"},
+}};
+
+// Accepts the names above as well as 0/1 for entropy/adversarial.
+inline Scoring parse_scoring(std::string_view const name) {
+    if (name == "0") {
+        return Scoring::entropy;
+    } else if (name == "1") {
+        return Scoring::adversarial;
+    }
+
+    for (std::size_t i = 0; i < scoring_names.size(); ++i) {
+        if (scoring_names[i].first == name) {
+            return static_cast<Scoring>(i);
+        }
+    }
+
+    throw std::invalid_argument("Unknown objective " + std::string{name} + "!");
+}
+
+inline std::string_view scoring_description(Scoring const scoring) {
+    return scoring_names[static_cast<std::size_t>(scoring)].second;
+}
+
+inline std::pair<Word, double> best_choice(std::vector<Word> const& allowed_choices,
+                                           std::vector<Word> const& remaining_words,
+                                           std::unordered_map<Word, double> const& word_freqs, Scoring const scoring) {
+    switch (scoring) {
+        case Scoring::entropy: return best_choice(allowed_choices, remaining_words, word_freqs, EntropyObjective{});
+        case Scoring::adversarial:
+            return best_choice(allowed_choices, remaining_words, word_freqs, AdversarialObjective{});
+        case Scoring::remaining: return best_choice(allowed_choices, remaining_words, word_freqs, RemainingObjective{});
+        case Scoring::solve_next:
+            return best_choice(allowed_choices, remaining_words, word_freqs, SolveNextObjective{});
+        case Scoring::expected_guesses:
+            return best_choice(allowed_choices, remaining_words, word_freqs, ExpectedGuessesObjective{});
+        case Scoring::max_bucket:
+            return best_choice(allowed_choices, remaining_words, word_freqs, MaxBucketObjective{});
+        case Scoring::fixed_entropy:
+            return best_choice(allowed_choices, remaining_words, word_freqs, FixedEntropyObjective{});
+    }
+
+    throw std::invalid_argument("Unknown objective!");
+}
+
+inline std::vector<Word> load_word_list(std::string const& filename) {
+    std::vector<Word> result;
+    std::ifstream file{filename};
+
+    Word w;
+
+    while (file >> w) {
+        result.push_back(w);
+    }
+
+    std::ranges::sort(result);
+
+    return result;
+}
+
+inline std::unordered_map<Word, double> load_freq_data(std::string const& filename) {
+    std::unordered_map<Word, double> result;
+    std::ifstream freq_data_file{filename};
+
+    Word w;
+    double f;
+
+    while (freq_data_file >> w >> f) {
+        result[w] = f;
+    }
+
+    return result;
+}
+
+// Best guess for the given game state using the same strategy as the interactive solver.
+inline Word pick_guess(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                       std::unordered_map<Word, double> const& word_freqs, Scoring const scoring) {
+    if (words.size() == 1) {
+        return words.front();
+    }
+
+    return best_choice(guesses, words, word_freqs, scoring).first;
+}
+
+// A complete strategy: every node stores the word to guess in that game state and, for every possible response other
+// than all_green, the node to continue from. Node 0 is the root.
+struct StrategyNode {
+    Word guess;
+    bool solves = false;  // Whether "guess" is one of the remaining words, i.e. whether all_green is possible.
+    std::vector<std::pair<Feedback, std::size_t>> children;  // Sorted by feedback.
+};
+
+using StrategyTree = std::vector<StrategyNode>;
+
+// Computes the decision tree that results from always playing pick_guess. Every word from "word_list" ends up at a
+// node that guesses it.
+inline StrategyTree build_strategy_tree(std::vector<Word> const& guess_list, std::vector<Word> const& word_list,
+                                        std::unordered_map<Word, double> const& word_freqs, bool const hard_mode,
+                                        Scoring const scoring) {
+    StrategyTree tree;
+
+    auto build = [&](auto& self, std::vector<Word> const& guesses, std::vector<Word> const& words) -> std::size_t {
+        std::size_t const index = tree.size();
+        Word const guess = pick_guess(guesses, words, word_freqs, scoring);
+        tree.push_back({guess, false, {}});
+
+        std::array<std::vector<Word>, num_feedbacks> buckets;
+
+        for (Word const& w : words) {
+            buckets[feedback_code(guess, w)].push_back(w);
+        }
+
+        if (std::ranges::any_of(buckets, [&](auto const& b) { return b.size() == words.size(); }) &&
+            buckets[all_green].empty()) {
+            throw std::runtime_error("Strategy does not make progress, are the word lists consistent?");
+        }
+
+        tree[index].solves = !buckets[all_green].empty();
+
+        for (std::size_t f = 0; f < all_green; ++f) {
+            if (buckets[f].empty()) {
+                continue;
+            }
+
+            std::size_t child;
+
+            if (hard_mode) {
+                child = self(self, filter_words(guesses, WordInfo{guess, buckets[f].front()}), buckets[f]);
+            } else {
+                child = self(self, guesses, buckets[f]);
+            }
+
+            tree[index].children.emplace_back(static_cast<Feedback>(f), child);
+        }
+
+        return index;
+    };
+
+    build(build, guess_list, word_list);
+    return tree;
+}
+
+// Binary strategy files are a flat array of 32 bit integers in native byte order so that they can be mapped into memory
+// and walked without any parsing or allocation:
+//   header: magic, version, number of words, size of the node region
+//   words:  the distinct guesses, one packed word (5 bits per letter) each
+//   nodes:  index of the guess, a bitmask over the 243 responses (8 integers) and one child offset for every set bit
+//           except all_green, which marks that the guess may be the secret word. Offsets are relative to the start of
+//           the node region, the root is at offset 0.
+constexpr std::uint32_t strategy_magic = 0x52545357;  // "WSTR"
+constexpr std::uint32_t strategy_version = 1;
+constexpr std::size_t strategy_header_size = 4;
+constexpr std::size_t strategy_mask_size = 8;
+
+inline std::uint32_t pack_word(Word const w) {
+    std::uint32_t result = 0;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        result |= static_cast<std::uint32_t>(w[i]) << (i * 5);
+    }
+
+    return result;
+}
+
+inline Word unpack_word(std::uint32_t const packed) {
+    Word result;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        result[i] = static_cast<char>((packed >> (i * 5)) & 31);
+    }
+
+    return result;
+}
+
+// Finalizer of splitmix64, a cheap way to turn structured 64 bit values into well distributed hashes.
+inline std::uint64_t mix64(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// Pseudo random 64 bit key of a word, the XOR of the keys of a set of words is its canonical hash: it does not depend
+// on the order of the words or on the guesses that narrowed them down, and removing a word updates it in O(1).
+inline std::uint64_t word_key(Word const w) {
+    return mix64(pack_word(w) + 0x9e3779b97f4a7c15ull);
+}
+
+inline std::uint64_t word_set_hash(std::span<Word const> const words) {
+    std::uint64_t result = 0;
+
+    for (Word const& w : words) {
+        result ^= word_key(w);
+    }
+
+    return result;
+}
+
+inline std::vector<std::uint32_t> serialize_strategy_tree(StrategyTree const& tree) {
+    std::vector<Word> words;
+
+    for (StrategyNode const& node : tree) {
+        words.push_back(node.guess);
+    }
+
+    std::ranges::sort(words);
+    auto const dups = std::ranges::unique(words);
+    words.erase(dups.begin(), dups.end());
+
+    std::vector<std::uint32_t> offsets(tree.size());
+    std::uint32_t node_region_size = 0;
+
+    for (std::size_t i = 0; i < tree.size(); ++i) {
+        offsets[i] = node_region_size;
+        node_region_size += 1 + strategy_mask_size + tree[i].children.size();
+    }
+
+    std::vector<std::uint32_t> result{strategy_magic, strategy_version, static_cast<std::uint32_t>(words.size()),
+                                      node_region_size};
+
+    for (Word const& w : words) {
+        result.push_back(pack_word(w));
+    }
+
+    for (StrategyNode const& node : tree) {
+        result.push_back(std::ranges::lower_bound(words, node.guess) - words.begin());
+
+        std::array<std::uint32_t, strategy_mask_size> mask{0};
+
+        for (auto const& [f, child] : node.children) {
+            mask[f / 32] |= 1u << (f % 32);
+        }
+
+        if (node.solves) {
+            mask[all_green / 32] |= 1u << (all_green % 32);
+        }
+
+        result.insert(result.end(), mask.begin(), mask.end());
+
+        for (auto const& [f, child] : node.children) {
+            result.push_back(offsets[child]);
+        }
+    }
+
+    return result;
+}
+
+inline void save_strategy_tree(StrategyTree const& tree, std::string const& filename) {
+    std::vector<std::uint32_t> const data = serialize_strategy_tree(tree);
+    std::ofstream file{filename, std::ios::binary};
+    file.write(reinterpret_cast<char const*>(data.data()), data.size() * sizeof(std::uint32_t));
+
+    if (!file) {
+        throw std::runtime_error("Could not write strategy file " + filename + "!");
+    }
+}
+
+// Read-only memory mapping of a whole file, used to load binary data without copying it.
+class MappedFile {
+public:
+    explicit MappedFile(std::string const& filename) {
+        int const fd = ::open(filename.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::runtime_error("Could not open " + filename + "!");
+        }
+
+        struct stat st;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = st.st_size;
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        ::close(fd);
+
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw std::runtime_error("Could not map " + filename + " into memory!");
+        }
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    std::span<std::uint32_t const> words() const {
+        return {static_cast<std::uint32_t const*>(data_), size_ / sizeof(std::uint32_t)};
+    }
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Allocation free reader for serialized strategy trees (see serialize_strategy_tree). Nodes are identified by their
+// offset into the node region, finding the child for a response is a popcount over the response mask.
+class StrategyView {
+public:
+    using Node = std::uint32_t;
+
+    explicit StrategyView(std::span<std::uint32_t const> const data) {
+        if (data.size() < strategy_header_size || data[0] != strategy_magic || data[1] != strategy_version ||
+            data.size() != strategy_header_size + data[2] + data[3]) {
+            throw std::runtime_error("Invalid strategy file!");
+        }
+
+        words_ = data.subspan(strategy_header_size, data[2]);
+        nodes_ = data.subspan(strategy_header_size + data[2]);
+
+        if (nodes_.empty()) {
+            throw std::runtime_error("Strategy file does not contain any nodes!");
+        }
+
+        // Validate once so that lookups do not need any bounds checks: every word has to consist of letters, every
+        // node has to fit into the node region and every child offset has to point to the start of a later node.
+        // Offsets that only point forward also rule out cycles, which would send the recursive traversals into endless
+        // recursion.
+        auto const is_word = [](std::uint32_t const w) {
+            return std::ranges::all_of(unpack_word(w), [](char const c) { return c < 26; });
+        };
+
+        if (!std::ranges::all_of(words_, is_word)) {
+            throw std::runtime_error("Invalid strategy file!");
+        }
+
+        std::vector<char> node_start(nodes_.size(), false);
+
+        for (std::size_t n = 0; n < nodes_.size(); n += node_size(n)) {
+            if (n + 1 + strategy_mask_size > nodes_.size() || n + node_size(n) > nodes_.size() ||
+                nodes_[n] >= words_.size()) {
+                throw std::runtime_error("Invalid strategy file!");
+            }
+
+            node_start[n] = true;
+        }
+
+        for (std::size_t n = 0; n < nodes_.size(); n += node_size(n)) {
+            auto const invalid = [&](std::uint32_t const c) { return c <= n || c >= nodes_.size() || !node_start[c]; };
+
+            if (std::ranges::any_of(children(n), invalid)) {
+                throw std::runtime_error("Invalid strategy file!");
+            }
+        }
+    }
+
+    Node root() const {
+        return 0;
+    }
+
+    Word guess(Node const n) const {
+        return unpack_word(words_[nodes_[n]]);
+    }
+
+    bool has_response(Node const n, Feedback const f) const {
+        return (nodes_[n + 1 + f / 32] >> (f % 32)) & 1;
+    }
+
+    // Whether the guess at this node can be the secret word.
+    bool solves(Node const n) const {
+        return has_response(n, all_green);
+    }
+
+    std::optional<Node> child(Node const n, Feedback const f) const {
+        if (f == all_green || !has_response(n, f)) {
+            return std::nullopt;
+        }
+
+        return children(n)[rank(n, f)];
+    }
+
+    // Calls fn(feedback, child) for every child of n in order of feedback.
+    template <typename Fn>
+    void for_each_child(Node const n, Fn&& fn) const {
+        for (std::size_t f = 0; f < all_green; ++f) {
+            if (has_response(n, static_cast<Feedback>(f))) {
+                std::invoke(fn, static_cast<Feedback>(f), children(n)[rank(n, static_cast<Feedback>(f))]);
+            }
+        }
+    }
+
+    std::size_t num_words() const {
+        return words_.size();
+    }
+
+private:
+    std::span<std::uint32_t const> words_;
+    std::span<std::uint32_t const> nodes_;
+
+    // Number of children of n with a response smaller than f.
+    std::size_t rank(Node const n, Feedback const f) const {
+        std::size_t result = std::popcount(nodes_[n + 1 + f / 32] & ((1u << (f % 32)) - 1));
+
+        for (std::size_t i = 0; i < f / 32; ++i) {
+            result += std::popcount(nodes_[n + 1 + i]);
+        }
+
+        return result;
+    }
+
+    std::size_t node_size(std::size_t const n) const {
+        return 1 + strategy_mask_size + rank(n, all_green);
+    }
+
+    std::span<std::uint32_t const> children(std::size_t const n) const {
+        return nodes_.subspan(n + 1 + strategy_mask_size, rank(n, all_green));
+    }
+};
+
+// Writes the strategy in the plain text format commonly used to share Wordle strategies: one line per secret word with
+// every guess followed by its response in uppercase, ending in GGGGG and the number of guesses, e.g.
+// "salet BYBBB courd GGGGG2".
+inline void export_strategy_text(StrategyView const& strategy, std::ostream& os) {
+    std::vector<std::pair<Word, Feedback>> path;
+
+    auto visit = [&](auto& self, StrategyView::Node const n) -> void {
+        Word const guess = strategy.guess(n);
+
+        if (strategy.solves(n)) {
+            for (auto const& [w, f] : path) {
+                std::string response = feedback_string(f);
+                std::ranges::transform(response, response.begin(), [](char c) { return std::toupper(c); });
+                os << w << ' ' << response << ' ';
+            }
+
+            os << guess << " GGGGG" << path.size() + 1 << '\n';
+        }
+
+        strategy.for_each_child(n, [&](Feedback const f, StrategyView::Node const child) {
+            path.emplace_back(guess, f);
+            self(self, child);
+            path.pop_back();
+        });
+    };
+
+    visit(visit, strategy.root());
+}
+
+// Words solved by the strategy below node n, each with the number of guesses it takes from n (including the one at n).
+inline std::vector<std::pair<Word, std::size_t>> strategy_solutions(StrategyView const& strategy,
+                                                                    StrategyView::Node const n) {
+    std::vector<std::pair<Word, std::size_t>> result;
+
+    auto visit = [&](auto& self, StrategyView::Node const node, std::size_t const guesses) -> void {
+        if (strategy.solves(node)) {
+            result.emplace_back(strategy.guess(node), guesses);
+        }
+
+        strategy.for_each_child(node, [&](Feedback, StrategyView::Node const child) { self(self, child, guesses + 1); });
+    };
+
+    visit(visit, n, 1);
+    return result;
+}
+
+// Reads a strategy in the text format of export_strategy_text. Responses are matched case insensitively and the
+// trailing guess count after GGGGG is optional, so strategies published by third parties can be loaded as well.
+inline StrategyTree parse_strategy_text(std::istream& is) {
+    StrategyTree tree;
+    std::string line;
+    std::size_t line_number = 0;
+
+    auto fail = [&](std::string const& msg) {
+        throw std::runtime_error("Line " + std::to_string(line_number) + " of strategy: " + msg);
+    };
+
+    while (std::getline(is, line)) {
+        ++line_number;
+        std::istringstream tokens{line};
+        std::size_t node = 0;
+        Word guess;
+        std::string response;
+
+        if (!(tokens >> guess)) {
+            continue;
+        }
+
+        if (tree.empty()) {
+            tree.push_back({guess, false, {}});
+        }
+
+        while (true) {
+            if (tree[node].guess != guess) {
+                fail("different guesses for the same game state!");
+            }
+
+            if (!(tokens >> response) || response.size() < 5) {
+                fail("expected a response after every guess!");
+            }
+
+            Feedback const f = parse_feedback(response.substr(0, 5));
+
+            if (f == all_green) {
+                tree[node].solves = true;
+                break;
+            }
+
+            if (!(tokens >> guess)) {
+                fail("line does not end in GGGGG!");
+            }
+
+            auto& children = tree[node].children;
+            auto const it = std::ranges::find(children, f, &std::pair<Feedback, std::size_t>::first);
+
+            if (it != children.end()) {
+                node = it->second;
+            } else {
+                children.emplace_back(f, tree.size());
+                node = tree.size();
+                tree.push_back({guess, false, {}});
+            }
+        }
+    }
+
+    if (tree.empty()) {
+        throw std::runtime_error("Strategy is empty!");
+    }
+
+    for (StrategyNode& n : tree) {
+        std::ranges::sort(n.children);
+    }
+
+    return tree;
+}
+
+// Loads a strategy either from a binary file (which is mapped into memory) or from the text format.
+class LoadedStrategy {
+public:
+    explicit LoadedStrategy(std::string const& filename) {
+        std::ifstream file{filename, std::ios::binary};
+        std::uint32_t magic = 0;
+
+        if (!file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) || magic != strategy_magic) {
+            file.clear();
+            file.seekg(0);
+            data_ = serialize_strategy_tree(parse_strategy_text(file));
+            view_.emplace(data_);
+        } else {
+            mapping_.emplace(filename);
+            view_.emplace(mapping_->words());
+        }
+    }
+
+    StrategyView const& view() const {
+        return *view_;
+    }
+
+private:
+    std::optional<MappedFile> mapping_;
+    std::vector<std::uint32_t> data_;
+    std::optional<StrategyView> view_;
+};
+
+struct VerifyReport {
+    std::size_t solved = 0;
+    std::size_t hard_mode_violations = 0;  // Number of words whose games contain a non-hard-mode guess.
+    std::vector<std::size_t> guess_distribution;  // Number of words solved with exactly i guesses.
+    std::size_t total_guesses = 0;
+    std::vector<Word> failed_words;  // Words which are not solved within max_guesses.
+};
+
+// Replays the strategy for every word in "word_list" and collects statistics about it. A guess is hard mode compliant
+// if it would produce the same responses as the secret word for all previous guesses.
+inline VerifyReport verify_strategy(StrategyView const& strategy, std::vector<Word> const& word_list,
+                                    std::size_t const max_guesses) {
+    struct Outcome {
+        std::size_t guesses = 0;  // 0 if the word is not solved.
+        bool hard_mode = true;
+    };
+
+    std::vector<Outcome> outcomes(word_list.size());
+
+    std::transform(std::execution::par_unseq, word_list.begin(), word_list.end(), outcomes.begin(),
+                   [&](Word const truth) {
+                       Outcome result;
+                       StrategyView::Node node = strategy.root();
+
+                       for (std::size_t i = 1; i <= max_guesses; ++i) {
+                           Word const guess = strategy.guess(node);
+
+                           // Games are short, so rather than storing them we replay from the root to check the
+                           // guess against every earlier response.
+                           StrategyView::Node prev = strategy.root();
+
+                           for (std::size_t j = 1; j < i; ++j) {
+                               Word const prev_guess = strategy.guess(prev);
+                               Feedback const f = feedback_code(prev_guess, truth);
+                               result.hard_mode &= feedback_code(prev_guess, guess) == f;
+                               prev = *strategy.child(prev, f);
+                           }
+
+                           Feedback const f = feedback_code(guess, truth);
+
+                           if (f == all_green) {
+                               result.guesses = i;
+                               break;
+                           }
+
+                           auto const next = strategy.child(node, f);
+
+                           if (!next) {
+                               break;
+                           }
+
+                           node = *next;
+                       }
+
+                       return result;
+                   });
+
+    VerifyReport report;
+    report.guess_distribution.resize(max_guesses + 1);
+
+    for (std::size_t i = 0; i < word_list.size(); ++i) {
+        if (outcomes[i].guesses == 0) {
+            report.failed_words.push_back(word_list[i]);
+            continue;
+        }
+
+        ++report.solved;
+        ++report.guess_distribution[outcomes[i].guesses];
+        report.total_guesses += outcomes[i].guesses;
+        report.hard_mode_violations += !outcomes[i].hard_mode;
+    }
+
+    return report;
+}
+
+// Plays a full game against every word of "secrets" exactly like the interactive solver does, including the WordInfo
+// filtering after every response. Unlike building a strategy tree nothing is shared between games except the first
+// guess, which makes this a representative workload for the interactive solver.
+inline VerifyReport simulate_games(std::vector<Word> const& guess_list, std::vector<Word> const& word_list,
+                                   std::vector<Word> const& secrets, std::unordered_map<Word, double> const& word_freqs,
+                                   bool const hard_mode, Scoring const scoring, std::size_t const max_guesses) {
+    VerifyReport report;
+    report.guess_distribution.resize(max_guesses + 1);
+    Word const opener = pick_guess(guess_list, word_list, word_freqs, scoring);
+
+    for (Word const& secret : secrets) {
+        std::vector<Word> guesses = guess_list;
+        std::vector<Word> words = word_list;
+        Word guess = opener;
+        std::size_t num_guesses = 1;
+
+        for (; guess != secret && num_guesses <= max_guesses; ++num_guesses) {
+            WordInfo const info{guess, secret};
+
+            words = filter_words(words, info);
+
+            if (hard_mode) {
+                guesses = filter_words(guesses, info);
+            }
+
+            guess = pick_guess(guesses, words, word_freqs, scoring);
+        }
+
+        if (num_guesses > max_guesses) {
+            report.failed_words.push_back(secret);
+            continue;
+        }
+
+        ++report.solved;
+        ++report.guess_distribution[num_guesses];
+        report.total_guesses += num_guesses;
+    }
+
+    return report;
+}
+
+// Fitted estimate of the number of guesses still needed to solve a set of remaining words, counting the guess that
+// solves it. Besides the size it takes into account in how many positions the words differ: sets like "catch, hatch,
+// latch, match" which agree everywhere but in one position take many more guesses than their size suggests.
+struct CostModel {
+    static constexpr std::size_t num_features = 4;
+
+    // Defaults to GuessCurve, i.e. ignores the structure of the set.
+    std::array<double, num_features> coeffs{1.215, 0.293, -0.00825, 0.0};
+
+    static std::array<double, num_features> features(std::size_t const n, std::size_t const differing_positions) {
+        double const x = std::log2(n);
+        return {1.0, x, x * x, x * static_cast<double>(5 - differing_positions)};
+    }
+
+    double operator()(std::size_t const n, std::size_t const differing_positions) const {
+        if (n <= 1) {
+            return n;
+        }
+
+        auto const phi = features(n, differing_positions);
+        return std::inner_product(phi.begin(), phi.end(), coeffs.begin(), 0.0);
+    }
+};
+
+inline std::size_t differing_positions(std::vector<Word> const& words) {
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        result += std::ranges::any_of(words, [&](Word const& w) { return w[i] != words.front()[i]; });
+    }
+
+    return result;
+}
+
+// Histogram of a guess together with the positions in which the words of each bucket differ, which is all the cost
+// model needs to evaluate the partition without materializing the buckets.
+struct PartitionStats {
+    Histogram counts{0};
+    std::array<Word, num_feedbacks> first;
+    std::array<std::uint8_t, num_feedbacks> differing{0};  // Bitmask over positions.
+
+    PartitionStats(Word const guess, std::vector<Word> const& words) {
+        for (Word const& truth : words) {
+            Feedback const f = feedback_code(guess, truth);
+
+            if (counts[f]++ == 0) {
+                first[f] = truth;
+                continue;
+            }
+
+            for (std::size_t i = 0; i < 5; ++i) {
+                differing[f] |= (truth[i] != first[f][i]) << i;
+            }
+        }
+    }
+
+    // Expected number of guesses to solve the words, starting with the guess that produced this partition.
+    double expected_cost(CostModel const& model, std::size_t const n) const {
+        double result = 0.0;
+
+        for (std::size_t f = 0; f < all_green; ++f) {
+            result += counts[f] > 0 ? counts[f] * model(counts[f], std::popcount(differing[f])) : 0.0;
+        }
+
+        return 1.0 + result / n;
+    }
+};
+
+// Lower bound on the expected number of guesses to solve n words: at best one word is solved by the next guess and
+// all others by the one after.
+inline double cost_lower_bound(std::size_t const n) {
+    return n <= 1 ? n : 2.0 - 1.0 / n;
+}
+
+// Fixed size table of search results keyed by canonical state hashes, shared by all search threads without locks. Each
+// bucket fills a cache line with two slots: the first keeps the deepest result (unless it is left over from an earlier
+// search), the second always takes the newest one. Slots store their key XOR their data, so a read racing with a write
+// fails the check and counts as a miss instead of returning a mix of two entries.
+class TranspositionTable {
+public:
+    // Exact result of a search "depth" guesses deep. Searches of a state are never cut off (only the guesses within
+    // them are), so the table does not need to keep bounds.
+    struct Entry {
+        Word best;
+        double score;
+        std::uint8_t depth = 0;
+    };
+
+    // Table of at most "bytes" bytes, at least one bucket.
+    explicit TranspositionTable(std::size_t const bytes)
+        : buckets_(std::bit_floor(std::max<std::size_t>(bytes / sizeof(Bucket), 1))) {}
+
+    std::optional<Entry> probe(std::uint64_t const key) {
+        probes_.fetch_add(1, std::memory_order_relaxed);
+
+        for (Slot const& slot : bucket(key).slots) {
+            auto const [meta, score] = slot.load(key);
+
+            if (meta & used_bit) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return unpack(meta, score);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void store(std::uint64_t const key, Entry const& entry) {
+        std::array<Slot, 2>& slots = bucket(key).slots;
+        std::uint64_t const preferred = slots[0].meta.load(std::memory_order_relaxed);
+        bool const replace_preferred = !(preferred & used_bit) || slots[0].load(key).first != 0 ||
+                                       generation(preferred) != generation_ || depth(preferred) <= entry.depth;
+        Slot& target = replace_preferred ? slots[0] : slots[1];
+        std::uint64_t const old = target.meta.load(std::memory_order_relaxed);
+
+        if ((old & used_bit) && generation(old) == generation_ && target.load(key).first == 0) {
+            collisions_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::uint64_t const meta = pack_word(entry.best) | std::uint64_t{entry.depth} << depth_shift |
+                                   std::uint64_t{generation_} << generation_shift | used_bit;
+        target.store(key, meta, std::bit_cast<std::uint64_t>(entry.score));
+        stores_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Entries in use together with their keys, e.g. for saving them. Safe while other threads use the table, entries
+    // that change while they are copied are skipped.
+    std::vector<std::pair<std::uint64_t, Entry>> entries() const {
+        std::vector<std::pair<std::uint64_t, Entry>> result;
+
+        for (Bucket const& b : buckets_) {
+            for (Slot const& slot : b.slots) {
+                std::uint64_t const meta = slot.meta.load(std::memory_order_relaxed);
+                std::uint64_t const score = slot.score.load(std::memory_order_relaxed);
+                std::uint64_t const check = slot.check.load(std::memory_order_relaxed);
+
+                if ((meta & used_bit) && slot.meta.load(std::memory_order_relaxed) == meta &&
+                    slot.score.load(std::memory_order_relaxed) == score) {
+                    result.emplace_back(check ^ meta ^ score, unpack(meta, score));
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Starts a new search: the entries stay valid, but the depth preferred slots may be replaced by shallower results.
+    void new_search() {
+        ++generation_;
+    }
+
+    void clear() {
+        for (Bucket& b : buckets_) {
+            for (Slot& slot : b.slots) {
+                slot.store(0, 0, 0);
+            }
+        }
+
+        probes_ = hits_ = stores_ = collisions_ = 0;
+    }
+
+    std::size_t memory_usage() const {
+        return buckets_.size() * sizeof(Bucket);
+    }
+
+    // Fraction of slots in use, by scanning the table.
+    double fill_rate() const {
+        std::size_t used = 0;
+
+        for (Bucket const& b : buckets_) {
+            for (Slot const& slot : b.slots) {
+                used += (slot.meta.load(std::memory_order_relaxed) & used_bit) != 0;
+            }
+        }
+
+        return static_cast<double>(used) / static_cast<double>(2 * buckets_.size());
+    }
+
+    std::size_t probes() const {
+        return probes_;
+    }
+
+    std::size_t hits() const {
+        return hits_;
+    }
+
+    std::size_t stores() const {
+        return stores_;
+    }
+
+    // Number of stores that replaced the entry of another state from the current search.
+    std::size_t collisions() const {
+        return collisions_;
+    }
+
+private:
+    // Layout of the meta data: packed best word, depth, generation and whether the slot is in use.
+    static constexpr std::uint64_t word_mask = (1u << 25) - 1;
+    static constexpr int depth_shift = 25;
+    static constexpr int generation_shift = 33;
+    static constexpr std::uint64_t used_bit = std::uint64_t{1} << 41;
+
+    static std::uint8_t depth(std::uint64_t const meta) {
+        return static_cast<std::uint8_t>(meta >> depth_shift);
+    }
+
+    static std::uint8_t generation(std::uint64_t const meta) {
+        return static_cast<std::uint8_t>(meta >> generation_shift);
+    }
+
+    static Entry unpack(std::uint64_t const meta, std::uint64_t const score) {
+        return {unpack_word(meta & word_mask), std::bit_cast<double>(score), depth(meta)};
+    }
+
+    struct Slot {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> meta;
+        std::atomic<std::uint64_t> score;
+
+        // Meta data and score if the slot holds a consistent entry for the key, zeros otherwise.
+        std::pair<std::uint64_t, std::uint64_t> load(std::uint64_t const key) const {
+            std::uint64_t const m = meta.load(std::memory_order_relaxed);
+            std::uint64_t const s = score.load(std::memory_order_relaxed);
+
+            if ((check.load(std::memory_order_relaxed) ^ m ^ s) != key) {
+                return {0, 0};
+            }
+
+            return {m, s};
+        }
+
+        void store(std::uint64_t const key, std::uint64_t const m, std::uint64_t const s) {
+            check.store(key ^ m ^ s, std::memory_order_relaxed);
+            meta.store(m, std::memory_order_relaxed);
+            score.store(s, std::memory_order_relaxed);
+        }
+    };
+
+    struct alignas(64) Bucket {
+        std::array<Slot, 2> slots;
+    };
+
+    Bucket& bucket(std::uint64_t const key) {
+        return buckets_[key & (buckets_.size() - 1)];
+    }
+
+    std::vector<Bucket> buckets_;
+    std::uint8_t generation_ = 0;
+    std::atomic<std::size_t> probes_ = 0;
+    std::atomic<std::size_t> hits_ = 0;
+    std::atomic<std::size_t> stores_ = 0;
+    std::atomic<std::size_t> collisions_ = 0;
+};
+
+constexpr std::size_t default_table_bytes = std::size_t{16} << 20;
+
+// Game states with fewer words are searched serially by the lookahead: their subtrees are too small to pay for tasks.
+constexpr std::size_t lookahead_parallel_words = 48;
+
+// Number of guesses that the lookahead searches on their own at a parallel state before the others start.
+constexpr std::size_t lookahead_eldest_brothers = 1;
+
+// Expected number of guesses to solve "words" (counting the last one) when the next "depth" guesses are searched and
+// the cost model evaluates the leaves. Only the "width" guesses with the best one ply estimate are searched at every
+// node and branches are cut as soon as they cannot beat the best guess found so far. Results are kept in the table by
+// the hash of words, depth and in hard mode the guesses, so that sets of words reached through different guesses are
+// searched once; a table may be reused for searches with the same model and width.
+//
+// States with at least "parallel_words" words search their guesses in parallel and within every guess the buckets,
+// largest first, so that the work stealing scheduler starts the longest tasks early. Guesses are given up once they
+// cannot beat the best one found by any thread. Small states run serially with pruning. Both ways add the costs of the
+// buckets in the same order and give the same result.
+inline std::pair<Word, double> best_choice_lookahead(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                                     CostModel const& model, bool hard_mode, std::size_t depth,
+                                                     std::size_t width, TranspositionTable& table,
+                                                     std::size_t parallel_words = lookahead_parallel_words);
+
+// Key of a lookahead search in the transposition table. The guesses are mixed in after the words, since in hard mode
+// they are often the same set and two symmetric terms would cancel out.
+inline std::uint64_t lookahead_key(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                   bool const hard_mode, std::size_t const depth) {
+    std::uint64_t const key = mix64(word_set_hash(words) + depth);
+    return hard_mode ? mix64(key ^ word_set_hash(guesses)) : key;
+}
+
+// The "width" guesses with the best one ply estimate, which the lookahead searches in this order.
+inline std::vector<std::pair<double, Word>> lookahead_candidates(std::vector<Word> const& guesses,
+                                                                 std::vector<Word> const& words,
+                                                                 CostModel const& model, std::size_t const width) {
+    std::vector<std::pair<double, Word>> ranked(guesses.size());
+
+    std::transform(std::execution::par_unseq, guesses.begin(), guesses.end(), ranked.begin(), [&](Word const guess) {
+        // Prefer possible solutions among equal estimates.
+        double const bonus = std::ranges::binary_search(words, guess) ? 1e-9 : 0.0;
+        return std::pair{PartitionStats{guess, words}.expected_cost(model, words.size()) - bonus, guess};
+    });
+
+    std::size_t const num_candidates = std::min(width, ranked.size());
+    std::ranges::partial_sort(ranked, ranked.begin() + num_candidates);
+    ranked.resize(num_candidates);
+    return ranked;
+}
+
+// Expected number of guesses to solve "words" starting with "guess", with "depth" - 1 more guesses searched, or some
+// value of at least "cutoff()" as soon as it is clear that it cannot get below. States with at least "parallel_words"
+// words search the buckets in parallel; there the cutoff may be a shared bound that other guesses lower meanwhile and
+// a guess that cannot beat it is given up with the largest double as its cost (not infinity, which -Ofast assumes never
+// occurs). The buckets are searched by "search_bucket(guesses, bucket)", which returns the cost of the bucket with the
+// guesses left in it.
+template <typename Cutoff, typename SearchBucket>
+double lookahead_guess_cost(std::vector<Word> const& guesses, std::vector<Word> const& words, Word const guess,
+                            bool const hard_mode, std::size_t const parallel_words, Cutoff const& cutoff,
+                            SearchBucket const& search_bucket) {
+    bool const parallel = words.size() >= parallel_words;
+    std::array<std::vector<Word>, num_feedbacks> buckets;
+
+    for (Word const& w : words) {
+        buckets[feedback_code(guess, w)].push_back(w);
+    }
+
+    // Buckets that are not evaluated yet contribute their lower bound.
+    double total = 0.0;
+    std::vector<std::size_t> order;
+
+    for (std::size_t f = 0; f < all_green; ++f) {
+        total += buckets[f].size() * cost_lower_bound(buckets[f].size());
+
+        if (buckets[f].size() > 2) {
+            order.push_back(f);
+        }
+    }
+
+    std::ranges::stable_sort(order, std::ranges::greater{}, [&](std::size_t const f) { return buckets[f].size(); });
+
+    auto const search = [&](std::size_t const f) {
+        if (!hard_mode) {
+            return search_bucket(guesses, buckets[f]);
+        }
+
+        return search_bucket(filter_words(guesses, WordInfo{guess, buckets[f].front()}), buckets[f]);
+    };
+
+    std::array<double, num_feedbacks> costs;
+
+    if (parallel) {
+        // The order in which buckets finish varies, so the partial sum only decides when to give up (with some slack
+        // for rounding) and the result is summed again in a fixed order.
+        std::atomic<double> partial = total;
+        std::atomic<bool> aborted = false;
+
+        std::for_each(std::execution::par, order.begin(), order.end(), [&](std::size_t const f) {
+            if (aborted.load(std::memory_order_relaxed) ||
+                1.0 + partial.load(std::memory_order_relaxed) / words.size() > cutoff() + 1e-12) {
+                aborted.store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            costs[f] = search(f);
+            partial.fetch_add(buckets[f].size() * (costs[f] - cost_lower_bound(buckets[f].size())),
+                              std::memory_order_relaxed);
+        });
+
+        if (aborted) {
+            return std::numeric_limits<double>::max();
+        }
+    }
+
+    for (std::size_t const f : order) {
+        if (!parallel && 1.0 + total / words.size() >= cutoff()) {
+            break;
+        }
+
+        double const cost = parallel ? costs[f] : search(f);
+        total += buckets[f].size() * (cost - cost_lower_bound(buckets[f].size()));
+    }
+
+    return 1.0 + total / words.size();
+}
+
+// lookahead_guess_cost with the buckets searched by best_choice_lookahead.
+template <typename Cutoff>
+double lookahead_guess_cost(std::vector<Word> const& guesses, std::vector<Word> const& words, Word const guess,
+                            CostModel const& model, bool const hard_mode, std::size_t const depth,
+                            std::size_t const width, TranspositionTable& table, std::size_t const parallel_words,
+                            Cutoff const& cutoff) {
+    return lookahead_guess_cost(
+        guesses, words, guess, hard_mode, parallel_words, cutoff,
+        [&](std::vector<Word> const& bucket_guesses, std::vector<Word> const& bucket) {
+            return best_choice_lookahead(bucket_guesses, bucket, model, hard_mode, depth - 1, width, table,
+                                         parallel_words)
+                .second;
+        });
+}
+
+// Young brothers wait: the most promising of the "ranked" guesses are searched first to establish a bound, then their
+// siblings in parallel against the best cost found so far. "evaluate(guess, cutoff)" returns the cost of a guess like
+// lookahead_guess_cost. A guess that is given up costs more than the bound, so taking the first of the cheapest guesses
+// in rank order gives the same result as the serial search. A cost is published as the bound only after "evaluate"
+// returned it (release and acquire), so whatever "evaluate" did with it is visible to the guesses given up against it.
+template <typename Evaluate>
+std::pair<Word, double> young_brothers_wait(std::vector<std::pair<double, Word>> const& ranked,
+                                            Evaluate const& evaluate) {
+    std::size_t const num_eldest = std::min(lookahead_eldest_brothers, ranked.size());
+    std::vector<double> values(ranked.size(), std::numeric_limits<double>::max());
+    std::atomic<double> bound = std::numeric_limits<double>::max();
+
+    auto const lower_bound = [&](double const value) {
+        double current = bound.load(std::memory_order_relaxed);
+
+        while (value < current && !bound.compare_exchange_weak(current, value, std::memory_order_release,
+                                                               std::memory_order_relaxed)) {
+        }
+    };
+
+    auto const cutoff = [&] { return bound.load(std::memory_order_acquire); };
+
+    for (std::size_t i = 0; i < num_eldest; ++i) {
+        values[i] = evaluate(ranked[i].second, cutoff);
+        lower_bound(values[i]);
+    }
+
+    std::vector<std::size_t> indices(ranked.size() - num_eldest);
+    std::iota(indices.begin(), indices.end(), num_eldest);
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t const i) {
+        values[i] = evaluate(ranked[i].second, cutoff);
+        lower_bound(values[i]);
+    });
+
+    std::pair<Word, double> best{ranked.front().second, std::numeric_limits<double>::max()};
+
+    for (std::size_t i = 0; i < ranked.size(); ++i) {
+        if (values[i] < best.second) {
+            best = {ranked[i].second, values[i]};
+        }
+    }
+
+    return best;
+}
+
+inline std::pair<Word, double> best_choice_lookahead(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                                     CostModel const& model, bool const hard_mode,
+                                                     std::size_t const depth, std::size_t const width,
+                                                     TranspositionTable& table, std::size_t const parallel_words) {
+    if (words.size() <= 2) {
+        return {words.front(), cost_lower_bound(words.size())};
+    }
+
+    std::uint64_t const key = lookahead_key(guesses, words, hard_mode, depth);
+
+    if (std::optional<TranspositionTable::Entry> const entry = table.probe(key)) {
+        return {entry->best, entry->score};
+    }
+
+    auto const remember = [&](std::pair<Word, double> const result) {
+        table.store(key, {result.first, result.second, static_cast<std::uint8_t>(depth)});
+        return result;
+    };
+
+    std::vector<std::pair<double, Word>> const ranked = lookahead_candidates(guesses, words, model, width);
+
+    if (depth <= 1) {
+        return remember({ranked.front().second, ranked.front().first});
+    }
+
+    auto const evaluate = [&](Word const guess, auto const& cutoff) {
+        return lookahead_guess_cost(guesses, words, guess, model, hard_mode, depth, width, table, parallel_words,
+                                    cutoff);
+    };
+
+    // Large states search their guesses in parallel, smaller ones one after the other against the best cost so far.
+    if (words.size() >= parallel_words) {
+        return remember(young_brothers_wait(ranked, evaluate));
+    }
+
+    std::pair<Word, double> best{ranked.front().second, std::numeric_limits<double>::max()};
+
+    for (auto const& [estimate, guess] : ranked) {
+        double const value = evaluate(guess, [&] { return best.second; });
+
+        if (value < best.second) {
+            best = {guess, value};
+        }
+    }
+
+    return remember(best);
+}
+
+inline std::pair<Word, double> best_choice_lookahead(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                                     CostModel const& model, bool const hard_mode,
+                                                     std::size_t const depth, std::size_t const width) {
+    TranspositionTable table{default_table_bytes};
+    return best_choice_lookahead(guesses, words, model, hard_mode, depth, width, table);
+}
+
+// Number of remaining words, positions in which they differ and average number of guesses the strategy needed to solve
+// them, for one game state encountered while playing.
+struct CostSample {
+    std::size_t n;
+    std::size_t differing_positions;
+    double guesses;
+};
+
+// Plays the strategy for every word of "word_list" and records a sample for every game state with at least two words.
+inline std::vector<CostSample> collect_cost_samples(StrategyTree const& tree, std::vector<Word> const& word_list) {
+    std::vector<CostSample> samples;
+
+    // Returns the total number of guesses needed to solve all of "words" from "node".
+    auto visit = [&](auto& self, std::size_t const node, std::vector<Word> const& words) -> std::size_t {
+        std::size_t total = words.size();
+
+        for (auto const& [f, child] : tree[node].children) {
+            std::vector<Word> bucket;
+            std::ranges::copy_if(words, std::back_inserter(bucket),
+                                 [&](Word const w) { return feedback_code(tree[node].guess, w) == f; });
+
+            if (!bucket.empty()) {
+                total += self(self, child, bucket);
+            }
+        }
+
+        if (words.size() >= 2) {
+            samples.push_back({words.size(), differing_positions(words), static_cast<double>(total) / words.size()});
+        }
+
+        return total;
+    };
+
+    visit(visit, 0, word_list);
+    return samples;
+}
+
+// Least squares fit of the cost model, with every sample weighted by its number of words since that is how often the
+// estimate is used.
+inline CostModel fit_cost_model(std::vector<CostSample> const& samples) {
+    constexpr std::size_t k = CostModel::num_features;
+    std::array<std::array<double, k + 1>, k> normal{};  // Augmented normal equations.
+
+    for (CostSample const& sample : samples) {
+        auto const phi = CostModel::features(sample.n, sample.differing_positions);
+
+        for (std::size_t i = 0; i < k; ++i) {
+            for (std::size_t j = 0; j < k; ++j) {
+                normal[i][j] += sample.n * phi[i] * phi[j];
+            }
+
+            normal[i][k] += sample.n * phi[i] * sample.guesses;
+        }
+    }
+
+    // Gaussian elimination with partial pivoting.
+    for (std::size_t col = 0; col < k; ++col) {
+        std::size_t const pivot = std::ranges::max_element(normal.begin() + col, normal.end(), {},
+                                                           [&](auto const& row) { return std::abs(row[col]); }) -
+                                  normal.begin();
+        std::swap(normal[col], normal[pivot]);
+
+        if (std::abs(normal[col][col]) < 1e-12) {
+            throw std::runtime_error("Not enough samples to fit the cost model!");
+        }
+
+        for (std::size_t row = 0; row < k; ++row) {
+            if (row != col) {
+                double const factor = normal[row][col] / normal[col][col];
+
+                for (std::size_t j = col; j <= k; ++j) {
+                    normal[row][j] -= factor * normal[col][j];
+                }
+            }
+        }
+    }
+
+    CostModel result;
+
+    for (std::size_t i = 0; i < k; ++i) {
+        result.coeffs[i] = normal[i][k] / normal[i][i];
+    }
+
+    return result;
+}
+
+// Weighted root mean square error of the model on the samples.
+inline double cost_model_error(CostModel const& model, std::vector<CostSample> const& samples) {
+    double error = 0.0, weight = 0.0;
+
+    for (CostSample const& sample : samples) {
+        double const diff = model(sample.n, sample.differing_positions) - sample.guesses;
+        error += sample.n * diff * diff;
+        weight += sample.n;
+    }
+
+    return std::sqrt(error / weight);
+}
+
+// The binary data file holds everything that is precomputed offline as a list of tagged sections (tag, size in bytes,
+// payload) so that every build step can add its own data without invalidating the rest.
+constexpr std::uint32_t data_magic = 0x46445357;      // "WSDF"
+constexpr std::uint32_t data_version = 1;
+constexpr std::uint32_t cost_model_tag = 0x54534f43;  // "COST"
+
+using DataSections = std::map<std::uint32_t, std::vector<char>>;
+
+inline DataSections load_data_file(std::string const& filename) {
+    std::ifstream file{filename, std::ios::binary};
+    std::array<std::uint32_t, 3> header{0};
+
+    if (!file.read(reinterpret_cast<char*>(header.data()), sizeof(header)) || header[0] != data_magic ||
+        header[1] != data_version) {
+        throw std::runtime_error("Invalid data file " + filename + "!");
+    }
+
+    DataSections result;
+
+    for (std::size_t i = 0; i < header[2]; ++i) {
+        std::array<std::uint32_t, 2> section{0};
+        file.read(reinterpret_cast<char*>(section.data()), sizeof(section));
+
+        std::vector<char>& payload = result[section[0]];
+        payload.resize(section[1]);
+        file.read(payload.data(), payload.size());
+    }
+
+    if (!file) {
+        throw std::runtime_error("Data file " + filename + " is truncated!");
+    }
+
+    return result;
+}
+
+inline void save_data_file(DataSections const& sections, std::string const& filename) {
+    std::ofstream file{filename, std::ios::binary};
+    std::array<std::uint32_t, 3> const header{data_magic, data_version, static_cast<std::uint32_t>(sections.size())};
+    file.write(reinterpret_cast<char const*>(header.data()), sizeof(header));
+
+    for (auto const& [tag, payload] : sections) {
+        std::array<std::uint32_t, 2> const section{tag, static_cast<std::uint32_t>(payload.size())};
+        file.write(reinterpret_cast<char const*>(section.data()), sizeof(section));
+        file.write(payload.data(), payload.size());
+    }
+
+    if (!file) {
+        throw std::runtime_error("Could not write data file " + filename + "!");
+    }
+}
+
+// Falls back to the default model if the data file does not contain a fitted one.
+inline CostModel load_cost_model(DataSections const& sections) {
+    CostModel result;
+
+    if (auto const it = sections.find(cost_model_tag); it != sections.end()) {
+        if (it->second.size() != sizeof(result.coeffs)) {
+            throw std::runtime_error("Invalid cost model in data file!");
+        }
+
+        std::memcpy(result.coeffs.data(), it->second.data(), sizeof(result.coeffs));
+    }
+
+    return result;
+}
+
+inline void store_cost_model(DataSections& sections, CostModel const& model) {
+    auto const* bytes = reinterpret_cast<char const*>(model.coeffs.data());
+    sections[cost_model_tag].assign(bytes, bytes + sizeof(model.coeffs));
+}
+
+// Monte Carlo tree search over guesses for dictionaries that are too large for exact search. Every rollout samples a
+// secret word, descends the tree by PUCT using the entropy of each guess as its prior and finishes the game by guessing
+// random remaining words. Values are numbers of guesses, so smaller is better.
+struct MctsOptions {
+    std::chrono::milliseconds budget{1000};
+    std::size_t max_children = 32;  // Only the guesses with the best entropy are considered at every state.
+    double exploration = 1.5;
+    double temperature = 0.25;  // In bits, softens the prior computed from the entropy.
+    double virtual_loss_cost = 10.0;  // Pretend cost of rollouts that are still running.
+    std::size_t max_rollouts = std::numeric_limits<std::size_t>::max();  // Stops before the budget is used up.
+    std::size_t threads = 0;  // 0 uses all hardware threads.
+    std::uint64_t seed = 0;  // Every thread draws its secrets and rollouts from seed + its index.
+};
+
+struct MctsNode;
+
+struct MctsEdge {
+    Word guess;
+    double prior;
+    std::size_t visits = 0;
+    std::size_t virtual_losses = 0;
+    double total_cost = 0.0;
+    std::map<Feedback, std::unique_ptr<MctsNode>> children;
+};
+
+struct MctsNode {
+    std::vector<Word> words;
+    std::vector<MctsEdge> edges;
+    std::size_t visits = 0;
+    std::mutex mut;
+
+    MctsNode(std::vector<Word> ws, std::vector<Word> const& guesses, MctsOptions const& options, bool const parallel)
+        : words{std::move(ws)} {
+        if (words.size() == 1) {
+            edges.emplace_back(words.front(), 1.0);
+            return;
+        }
+
+        std::vector<std::pair<double, Word>> scores(guesses.size());
+        auto score = [&](Word const guess) {
+            double const bonus = std::ranges::binary_search(words, guess) ? 1e-9 : 0.0;
+            return std::pair{EntropyObjective{}(feedback_histogram(guess, words), words.size()) - bonus, guess};
+        };
+
+        if (parallel) {
+            std::transform(std::execution::par_unseq, guesses.begin(), guesses.end(), scores.begin(), score);
+        } else {
+            std::ranges::transform(guesses, scores.begin(), score);
+        }
+
+        std::size_t const k = std::min(options.max_children, scores.size());
+        std::ranges::partial_sort(scores, scores.begin() + k);
+
+        double total = 0.0;
+
+        for (auto const& [entropy, guess] : scores | std::views::take(k)) {
+            double const prior = std::exp((scores.front().first - entropy) / options.temperature);
+            edges.emplace_back(guess, prior);
+            total += prior;
+        }
+
+        for (MctsEdge& edge : edges) {
+            edge.prior /= total;
+        }
+    }
+
+    // PUCT with virtual losses so that concurrent rollouts spread over different guesses. Must hold "mut".
+    MctsEdge& select(MctsOptions const& options) {
+        double const sqrt_visits = std::sqrt(static_cast<double>(visits) + 1.0);
+        double const mean = visits > 0 ? total_cost() / visits : 0.0;
+
+        return *std::ranges::min_element(edges, {}, [&](MctsEdge const& e) {
+            std::size_t const n = e.visits + e.virtual_losses;
+            double const q = n > 0 ? (e.total_cost + e.virtual_losses * options.virtual_loss_cost) / n : mean;
+            return q - options.exploration * e.prior * sqrt_visits / (1.0 + n);
+        });
+    }
+
+    double total_cost() const {
+        return std::accumulate(edges.begin(), edges.end(), 0.0,
+                               [](double const acc, MctsEdge const& e) { return acc + e.total_cost; });
+    }
+};
+
+// Number of guesses needed to find "secret" among "words" by always guessing a random remaining word.
+inline std::size_t random_rollout(std::vector<Word> words, Word const secret, std::mt19937_64& rng) {
+    for (std::size_t guesses = 1;; ++guesses) {
+        Word const guess = words[std::uniform_int_distribution<std::size_t>{0, words.size() - 1}(rng)];
+        Feedback const f = feedback_code(guess, secret);
+
+        if (f == all_green) {
+            return guesses;
+        }
+
+        std::erase_if(words, [&](Word const w) { return feedback_code(guess, w) != f; });
+    }
+}
+
+struct MctsResult {
+    std::size_t rollouts;
+    std::vector<MctsEdge const*> ranking;  // Root edges sorted by visits.
+};
+
+// Runs rollouts on "root" until the time budget is used up. Secrets are sampled proportionally to "word_freqs" (words
+// without frequency data get the smallest known frequency), or uniformly if there is no frequency data.
+inline MctsResult mcts_search(MctsNode& root, std::vector<Word> const& guesses,
+                              std::unordered_map<Word, double> const& word_freqs, MctsOptions const& options) {
+    std::vector<double> weights(root.words.size(), 1.0);
+
+    if (!word_freqs.empty()) {
+        double const min_freq = std::ranges::min(word_freqs | std::views::values);
+
+        std::ranges::transform(root.words, weights.begin(), [&](Word const w) {
+            auto const it = word_freqs.find(w);
+            return std::max(it == word_freqs.end() ? min_freq : it->second, std::numeric_limits<double>::min());
+        });
+    }
+
+    std::discrete_distribution<std::size_t> const secrets{weights.begin(), weights.end()};
+    auto const deadline = std::chrono::steady_clock::now() + options.budget;
+    std::atomic<std::size_t> rollouts = 0;
+    std::size_t const threads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    std::vector<std::size_t> workers(std::max<std::size_t>(threads, 1));
+    std::iota(workers.begin(), workers.end(), 0);
+
+    std::for_each(std::execution::par, workers.begin(), workers.end(), [&](std::size_t const worker) {
+        std::mt19937_64 rng{options.seed + worker};
+        auto local_secrets = secrets;
+
+        while (std::chrono::steady_clock::now() < deadline && rollouts < options.max_rollouts) {
+            Word const secret = root.words[local_secrets(rng)];
+            std::vector<std::pair<MctsNode*, MctsEdge*>> path;
+            MctsNode* node = &root;
+            std::size_t cost = 0;
+
+            // Selection and expansion
+            while (true) {
+                std::unique_lock lock{node->mut};
+                MctsEdge& edge = node->select(options);
+                ++edge.virtual_losses;
+                path.emplace_back(node, &edge);
+
+                Feedback const f = feedback_code(edge.guess, secret);
+
+                if (f == all_green) {
+                    cost = path.size();
+                    break;
+                }
+
+                auto& child = edge.children[f];
+
+                if (child == nullptr) {
+                    // Scoring the guesses for the new node takes long near the root, so it happens without holding
+                    // the lock. If another rollout installs the same node meanwhile, this copy is dropped.
+                    lock.unlock();
+                    std::vector<Word> remaining;
+                    std::ranges::copy_if(node->words, std::back_inserter(remaining),
+                                         [&](Word const w) { return feedback_code(edge.guess, w) == f; });
+                    auto expanded = std::make_unique<MctsNode>(remaining, guesses, options, false);
+
+                    lock.lock();
+
+                    if (child == nullptr) {
+                        child = std::move(expanded);
+                    }
+
+                    lock.unlock();
+                    cost = path.size() + random_rollout(std::move(remaining), secret, rng);
+                    break;
+                }
+
+                node = child.get();
+            }
+
+            // Backpropagation: every edge gets the number of guesses from its own state onwards.
+            for (std::size_t depth = 0; depth < path.size(); ++depth) {
+                auto const [n, e] = path[depth];
+                std::lock_guard guard{n->mut};
+                --e->virtual_losses;
+                ++e->visits;
+                ++n->visits;
+                e->total_cost += static_cast<double>(cost - depth);
+            }
+
+            ++rollouts;
+        }
+    });
+
+    MctsResult result{rollouts, {}};
+
+    for (MctsEdge const& edge : root.edges) {
+        result.ranking.push_back(&edge);
+    }
+
+    std::ranges::stable_sort(result.ranking, std::greater{}, &MctsEdge::visits);
+    return result;
+}
+
+// Reduces the sizes of the buckets of a partition according to one of the objectives. Unlike the objectives themselves
+// this is not restricted to the 243 buckets of a single guess and is used to score partitions by several guesses. The
+// all green bucket is not special here, i.e. expected_guesses counts one more guess for it.
+class SizeReduction {
+public:
+    explicit SizeReduction(Scoring const scoring) : scoring_{scoring} {}
+
+    void add(std::size_t const n) {
+        switch (scoring_) {
+            case Scoring::entropy:
+            case Scoring::fixed_entropy: value_ += n > 1 ? n * std::log2(n) : 0.0; break;
+            case Scoring::adversarial:
+            case Scoring::max_bucket: value_ = std::max(value_, static_cast<double>(n)); break;
+            case Scoring::remaining: value_ += static_cast<double>(n) * n; break;
+            case Scoring::solve_next: value_ += 1.0; break;
+            case Scoring::expected_guesses: value_ += n * GuessCurve{}(n); break;
+        }
+    }
+
+    double result(std::size_t const total) const {
+        switch (scoring_) {
+            case Scoring::adversarial: return std::log2(value_);
+            case Scoring::max_bucket: return value_;
+            case Scoring::solve_next: return 1.0 - value_ / total;
+            default: return value_ / total;
+        }
+    }
+
+private:
+    Scoring scoring_;
+    double value_ = 0.0;
+};
+
+// Partition of the secret words into classes that a fixed sequence of guesses cannot tell apart. Classes are numbered
+// by first occurrence, so two sequences induce the same partition exactly if they have the same labels.
+struct JointPartition {
+    std::vector<Word> guesses;
+    std::vector<std::uint32_t> labels;  // Class of every word.
+    std::uint32_t num_classes = 1;
+    std::uint64_t signature = 0;
+    double score = 0.0;
+
+    explicit JointPartition(std::size_t const num_words) : labels(num_words, 0) {}
+
+    // Adds a guess (with its pattern matrix row) and splits every class by the responses to it.
+    JointPartition refine(Word const guess, std::span<Feedback const> const row) const {
+        JointPartition result{*this};
+        result.guesses.push_back(guess);
+        result.num_classes = 0;
+        result.signature = 0;
+
+        std::vector<std::uint32_t> relabel(num_classes * num_feedbacks, std::numeric_limits<std::uint32_t>::max());
+
+        for (std::size_t i = 0; i < row.size(); ++i) {
+            std::uint32_t& label = relabel[labels[i] * num_feedbacks + row[i]];
+
+            if (label == std::numeric_limits<std::uint32_t>::max()) {
+                label = result.num_classes++;
+            }
+
+            result.labels[i] = label;
+            result.signature = mix64(result.signature ^ label);
+        }
+
+        return result;
+    }
+};
+
+// The words of a partition grouped by class, which lets us score a refinement one class at a time with a histogram
+// over just 243 responses.
+struct ClassMembers {
+    std::vector<std::uint32_t> offsets;  // Words of class c are members[offsets[c]..offsets[c + 1]).
+    std::vector<std::uint32_t> members;  // Indices of the words.
+
+    explicit ClassMembers(JointPartition const& partition)
+        : offsets(partition.num_classes + 1, 0), members(partition.labels.size()) {
+        for (std::uint32_t const label : partition.labels) {
+            ++offsets[label + 1];
+        }
+
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> next{offsets.begin(), offsets.end() - 1};
+
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            members[next[partition.labels[i]]++] = i;
+        }
+    }
+
+    // Score of the partition after adding the guess with the given pattern matrix row. Singleton classes cannot be
+    // split, so they are skipped entirely.
+    double score_refinement(std::span<Feedback const> const row, Scoring const scoring) const {
+        SizeReduction reduction{scoring};
+        Histogram counts{0};
+        std::array<Feedback, num_feedbacks> touched;
+
+        for (std::size_t c = 0; c + 1 < offsets.size(); ++c) {
+            if (offsets[c + 1] - offsets[c] == 1) {
+                reduction.add(1);
+                continue;
+            }
+
+            std::size_t num_touched = 0;
+
+            for (std::size_t i = offsets[c]; i < offsets[c + 1]; ++i) {
+                Feedback const f = row[members[i]];
+
+                if (counts[f]++ == 0) {
+                    touched[num_touched++] = f;
+                }
+            }
+
+            for (std::size_t i = 0; i < num_touched; ++i) {
+                reduction.add(counts[touched[i]]);
+                counts[touched[i]] = 0;
+            }
+        }
+
+        return reduction.result(members.size());
+    }
+};
+
+// Beam search for the best sequences of "length" fixed guesses, scored by the partition of "words" they induce. Every
+// level expands all kept sequences by all guesses in parallel and keeps the "width" best ones, skipping sequences that
+// induce the same partition as a better one (e.g. permutations of the same guesses).
+inline std::vector<JointPartition> beam_search(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                               std::size_t const length, std::size_t const width,
+                                               Scoring const scoring) {
+    PatternMatrix const matrix{guesses, words};
+    std::vector<JointPartition> beam{JointPartition{words.size()}};
+
+    for (std::size_t level = 0; level < length; ++level) {
+        std::vector<ClassMembers> members;
+
+        for (JointPartition const& p : beam) {
+            members.emplace_back(p);
+        }
+
+        // Every pair of kept sequence and guess is a task of its own, the first level only has a single sequence.
+        std::vector<std::pair<double, std::size_t>> scored(beam.size() * guesses.size());
+
+        for (std::size_t index = 0; index < scored.size(); ++index) {
+            scored[index].second = index;
+        }
+
+        std::for_each(std::execution::par, scored.begin(), scored.end(), [&](std::pair<double, std::size_t>& entry) {
+            std::size_t const b = entry.second / guesses.size();
+            std::size_t const g = entry.second % guesses.size();
+            bool const repeated = std::ranges::find(beam[b].guesses, guesses[g]) != beam[b].guesses.end();
+            entry.first = repeated ? std::numeric_limits<double>::max()
+                                   : members[b].score_refinement(matrix.row(g), scoring);
+        });
+
+        // Duplicates are only found after refining, so look at a few more candidates than we keep.
+        std::size_t const num_candidates = std::min(scored.size(), width * 4);
+        std::ranges::partial_sort(scored, scored.begin() + num_candidates);
+
+        std::vector<JointPartition> next;
+        std::vector<std::uint64_t> signatures;
+
+        for (auto const& [score, index] : scored | std::views::take(num_candidates)) {
+            if (next.size() == width || score == std::numeric_limits<double>::max()) {
+                break;
+            }
+
+            std::size_t const g = index % guesses.size();
+            JointPartition refined = beam[index / guesses.size()].refine(guesses[g], matrix.row(g));
+
+            if (std::ranges::find(signatures, refined.signature) != signatures.end()) {
+                continue;
+            }
+
+            refined.score = score;
+            signatures.push_back(refined.signature);
+            next.push_back(std::move(refined));
+        }
+
+        beam = std::move(next);
+    }
+
+    return beam;
+}
+
+// Fingerprint of the inputs of a search, so that stored results are only reused for the same word lists and frequency
+// data. The frequencies are combined in an order independent way since they come from a hash map.
+inline std::uint64_t search_fingerprint(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                        std::unordered_map<Word, double> const& freqs = {}) {
+    std::uint64_t result = 0;
+
+    for (std::vector<Word> const* list : {&guesses, &words}) {
+        for (Word const& w : *list) {
+            result = mix64(result ^ pack_word(w));
+        }
+
+        result = mix64(result + 1);
+    }
+
+    std::uint64_t freq_hash = 0;
+
+    for (auto const& [w, freq] : freqs) {
+        freq_hash += mix64(mix64(pack_word(w)) ^ std::bit_cast<std::uint64_t>(freq));
+    }
+
+    return mix64(result ^ freq_hash);
+}
+
+// Best second guess for every response to an opener, precomputed by build_second_moves and stored in the data file so
+// that the first two turns need no search. A table only applies to the word lists, frequency data, mode and objective
+// it was built for.
+struct SecondMoveTable {
+    using Suggestion = std::pair<Word, double>;
+
+    std::uint64_t fingerprint = 0;
+    bool hard_mode = false;
+    Scoring scoring = Scoring::entropy;
+    Word opener{};
+    double opener_score = 0.0;
+    bool best_opener = false;  // Whether the opener is also the suggestion for the first turn.
+    std::vector<std::pair<Feedback, Suggestion>> replies;  // Sorted by response, impossible ones are left out.
+
+    bool applies_to(std::uint64_t const fp, bool const hard, Scoring const s) const {
+        return fingerprint == fp && hard_mode == hard && scoring == s;
+    }
+
+    std::optional<Suggestion> reply(Feedback const feedback) const {
+        auto const it = std::ranges::lower_bound(replies, feedback, {}, &std::pair<Feedback, Suggestion>::first);
+        return it == replies.end() || it->first != feedback ? std::nullopt : std::optional{it->second};
+    }
+};
+
+// Runs the same searches as the interactive loop would after "opener" (the best opener if not given) for every
+// response except all green.
+inline SecondMoveTable build_second_moves(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                          std::unordered_map<Word, double> const& freqs, bool const hard_mode,
+                                          Scoring const scoring, std::optional<Word> const opener = std::nullopt) {
+    SecondMoveTable result;
+    result.fingerprint = search_fingerprint(guesses, words, freqs);
+    result.hard_mode = hard_mode;
+    result.scoring = scoring;
+
+    auto const best = best_choice(guesses, words, freqs, scoring);
+    result.opener = opener.value_or(best.first);
+    result.best_opener = result.opener == best.first;
+    result.opener_score =
+        result.best_opener ? best.second : best_choice(std::vector{result.opener}, words, freqs, scoring).second;
+
+    std::vector<std::vector<Word>> buckets(num_feedbacks);
+
+    for (Word const& w : words) {
+        buckets[feedback_code(result.opener, w)].push_back(w);
+    }
+
+    for (std::size_t f = 0; f < all_green; ++f) {
+        if (buckets[f].empty()) {
+            continue;
+        }
+
+        std::vector<Word> const allowed =
+            hard_mode ? filter_words(guesses, WordInfo{result.opener, feedback_string(f)}) : guesses;
+        result.replies.emplace_back(f, best_choice(allowed, buckets[f], freqs, scoring));
+    }
+
+    return result;
+}
+
+constexpr std::uint32_t second_moves_tag = 0x564f4d53;  // "SMOV"
+
+// Section layout: number of tables, then per table the fingerprint (u64), flags (u32: hard mode in bit 0, best opener
+// in bit 1, objective in bits 8 to 15), packed opener (u32), opener score (f64), number of replies (u32) and for every
+// reply the response (u32), packed guess (u32) and score (f64).
+inline std::vector<SecondMoveTable> load_second_moves(DataSections const& sections) {
+    std::vector<SecondMoveTable> result;
+    auto const it = sections.find(second_moves_tag);
+
+    if (it == sections.end()) {
+        return result;
+    }
+
+    std::span<char const> data = it->second;
+
+    auto const read = [&]<typename T>(T& value) {
+        if (data.size() < sizeof(T)) {
+            throw std::runtime_error("Invalid second move table in data file!");
+        }
+
+        std::memcpy(&value, data.data(), sizeof(T));
+        data = data.subspan(sizeof(T));
+    };
+
+    std::uint32_t num_tables = 0;
+    read(num_tables);
+
+    for (std::uint32_t t = 0; t < num_tables; ++t) {
+        SecondMoveTable& table = result.emplace_back();
+        std::uint32_t flags = 0;
+        std::uint32_t opener = 0;
+        std::uint32_t num_replies = 0;
+        read(table.fingerprint);
+        read(flags);
+        read(opener);
+        read(table.opener_score);
+        read(num_replies);
+
+        if (((flags >> 8) & 0xff) >= scoring_names.size()) {
+            throw std::runtime_error("Invalid second move table in data file!");
+        }
+
+        table.hard_mode = flags & 1;
+        table.best_opener = (flags >> 1) & 1;
+        table.scoring = static_cast<Scoring>((flags >> 8) & 0xff);
+        table.opener = unpack_word(opener);
+
+        for (std::uint32_t r = 0; r < num_replies; ++r) {
+            std::uint32_t feedback = 0;
+            std::uint32_t guess = 0;
+            double score = 0.0;
+            read(feedback);
+            read(guess);
+            read(score);
+
+            if (feedback >= num_feedbacks || (!table.replies.empty() && table.replies.back().first >= feedback)) {
+                throw std::runtime_error("Invalid second move table in data file!");
+            }
+
+            table.replies.emplace_back(feedback, SecondMoveTable::Suggestion{unpack_word(guess), score});
+        }
+    }
+
+    return result;
+}
+
+inline void store_second_moves(DataSections& sections, std::vector<SecondMoveTable> const& tables) {
+    std::vector<char>& data = sections[second_moves_tag];
+    data.clear();
+
+    auto const write = [&](auto const value) {
+        auto const* bytes = reinterpret_cast<char const*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+    };
+
+    write(static_cast<std::uint32_t>(tables.size()));
+
+    for (SecondMoveTable const& table : tables) {
+        write(table.fingerprint);
+        write(static_cast<std::uint32_t>(table.hard_mode | (table.best_opener << 1) |
+                                         (static_cast<std::uint32_t>(table.scoring) << 8)));
+        write(pack_word(table.opener));
+        write(table.opener_score);
+        write(static_cast<std::uint32_t>(table.replies.size()));
+
+        for (auto const& [feedback, suggestion] : table.replies) {
+            write(static_cast<std::uint32_t>(feedback));
+            write(pack_word(suggestion.first));
+            write(suggestion.second);
+        }
+    }
+}
+
+// Guess and word lists together with their pattern matrix, shared by all games played on them.
+struct Dictionary {
+    std::vector<Word> guesses;
+    std::vector<Word> words;
+    PatternMatrix matrix;
+    std::uint64_t fingerprint;
+    std::vector<SecondMoveTable> second_moves;  // Only tables for these lists, normal mode and entropy are used.
+
+    Dictionary(std::vector<Word> guess_list, std::vector<Word> word_list)
+        : guesses{std::move(guess_list)},
+          words{std::move(word_list)},
+          matrix{guesses, words},
+          fingerprint{search_fingerprint(guesses, words)} {}
+};
+
+// Subset of a word list as a bitset over the indices of the words, starting out with all of them. The canonical hash
+// of the words in the set is maintained as words are erased.
+class WordSet {
+public:
+    explicit WordSet(std::vector<Word> const& list)
+        : list_{&list}, bits_((list.size() + 63) / 64, ~std::uint64_t{0}), hash_{word_set_hash(list)} {
+        if (list.size() % 64 != 0) {
+            bits_.back() = (std::uint64_t{1} << (list.size() % 64)) - 1;
+        }
+    }
+
+    bool contains(std::size_t const i) const {
+        return (bits_[i / 64] >> (i % 64)) & 1;
+    }
+
+    void erase(std::size_t const i) {
+        if (contains(i)) {
+            bits_[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+            hash_ ^= word_key((*list_)[i]);
+        }
+    }
+
+    // Equal to word_set_hash of the words in the set, so sets reached in different ways can be recognized.
+    std::uint64_t hash() const {
+        return hash_;
+    }
+
+    std::size_t size() const {
+        std::size_t result = 0;
+
+        for (std::uint64_t const b : bits_) {
+            result += std::popcount(b);
+        }
+
+        return result;
+    }
+
+    // Calls fn(i) for every index in the set in increasing order.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t block = 0; block < bits_.size(); ++block) {
+            for (std::uint64_t b = bits_[block]; b != 0; b &= b - 1) {
+                std::invoke(fn, block * 64 + std::countr_zero(b));
+            }
+        }
+    }
+
+    // The underlying bitset, bit i % 64 of block i / 64 is set if word i is in the set.
+    std::span<std::uint64_t const> blocks() const {
+        return bits_;
+    }
+
+    std::vector<std::uint32_t> indices() const {
+        std::vector<std::uint32_t> result;
+        result.reserve(size());
+        for_each([&](std::size_t const i) { result.push_back(i); });
+        return result;
+    }
+
+private:
+    std::vector<Word> const* list_;
+    std::vector<std::uint64_t> bits_;
+    std::uint64_t hash_;
+};
+
+// State of a game with several boards (Dordle, Quordle, ...) that share every guess but have separate secret words.
+// A game with one board is plain Wordle.
+class MultiGame {
+public:
+    using Turn = std::pair<Word, std::vector<Feedback>>;
+
+    MultiGame(Dictionary const& dict, std::size_t const num_boards)
+        : dict_{&dict}, candidates_(num_boards, WordSet{dict.words}), solved_(num_boards, false) {}
+
+    std::size_t num_boards() const {
+        return candidates_.size();
+    }
+
+    bool solved(std::size_t const board) const {
+        return solved_[board];
+    }
+
+    bool finished() const {
+        return std::ranges::all_of(solved_, std::identity{});
+    }
+
+    WordSet const& candidates(std::size_t const board) const {
+        return candidates_[board];
+    }
+
+    std::vector<Turn> const& history() const {
+        return history_;
+    }
+
+    // Applies the responses of all boards to "guess" at once. Responses for boards that are already solved are ignored.
+    void apply_feedback(Word const guess, std::span<Feedback const> const feedback) {
+        if (feedback.size() != num_boards()) {
+            throw std::invalid_argument("Expected one response per board!");
+        }
+
+        for (std::size_t b = 0; b < num_boards(); ++b) {
+            if (solved_[b]) {
+                continue;
+            }
+
+            solved_[b] = feedback[b] == all_green;
+            candidates_[b].for_each([&](std::size_t const i) {
+                if (feedback_code(guess, dict_->words[i]) != feedback[b]) {
+                    candidates_[b].erase(i);
+                }
+            });
+        }
+
+        history_.emplace_back(guess, std::vector<Feedback>{feedback.begin(), feedback.end()});
+    }
+
+    // Best next guess and its score, the sum of the average entropies of all unsolved boards after the guess. A board
+    // that is down to a single word is always finished first.
+    std::pair<Word, double> suggest() const {
+        std::vector<std::vector<std::uint32_t>> boards;
+
+        for (std::size_t b = 0; b < num_boards(); ++b) {
+            if (!solved_[b]) {
+                boards.push_back(candidates_[b].indices());
+
+                if (boards.back().empty()) {
+                    throw std::runtime_error("No words are consistent with the responses!");
+                }
+            }
+        }
+
+        if (boards.empty()) {
+            throw std::runtime_error("All boards are solved already!");
+        }
+
+        if (auto const stored = stored_suggestion()) {
+            return *stored;
+        }
+
+        for (auto const& board : boards) {
+            if (board.size() == 1) {
+                return {dict_->words[board.front()], 0.0};
+            }
+        }
+
+        std::vector<std::pair<double, std::size_t>> scores(dict_->guesses.size());
+
+        std::transform(std::execution::par_unseq, dict_->guesses.begin(), dict_->guesses.end(), scores.begin(),
+                       [&](Word const& guess) {
+                           std::size_t const g = &guess - dict_->guesses.data();
+                           std::span<Feedback const> const row = dict_->matrix.row(g);
+                           double score = 0.0;
+                           bool candidate = false;
+
+                           for (auto const& board : boards) {
+                               Histogram counts{0};
+
+                               // Boards with all words left, e.g. at the start, count the whole row at once.
+                               if (board.size() == row.size()) {
+                                   add_codes(row, counts);
+                               } else {
+                                   for (std::uint32_t const i : board) {
+                                       ++counts[row[i]];
+                                   }
+                               }
+
+                               candidate |= counts[all_green] > 0;
+                               score += EntropyObjective{}(counts, board.size());
+                           }
+
+                           // Prefer guesses that might solve a board among equal scores.
+                           return std::pair{score - (candidate ? 1e-9 : 0.0), g};
+                       });
+
+        auto const [score, g] = std::ranges::min(scores);
+        return {dict_->guesses[g], score};
+    }
+
+private:
+    // Plain Wordle on its first two turns can be answered from the second move tables of the dictionary.
+    std::optional<std::pair<Word, double>> stored_suggestion() const {
+        if (num_boards() != 1 || history_.size() > 1) {
+            return std::nullopt;
+        }
+
+        for (SecondMoveTable const& table : dict_->second_moves) {
+            if (!table.applies_to(dict_->fingerprint, false, Scoring::entropy)) {
+                continue;
+            }
+
+            if (history_.empty() && table.best_opener) {
+                return std::pair{table.opener, table.opener_score};
+            } else if (!history_.empty() && history_.front().first == table.opener) {
+                return table.reply(history_.front().second.front());
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    Dictionary const* dict_;
+    std::vector<WordSet> candidates_;
+    std::vector<bool> solved_;
+    std::vector<Turn> history_;
+};
+
+// Suggestions for game states that were seen before, persisted in a text file with one line per state: the context,
+// the canonical history and the suggested guess with its score, separated by tabs. The context identifies everything
+// besides the history that a suggestion depends on (word lists, mode, objective, ...), so every context should have a
+// file of its own. Files hold at most "max_cached_suggestions" entries, later ones are only kept in memory.
+class SuggestionCache {
+public:
+    using Turn = std::pair<Word, Feedback>;
+    using Suggestion = std::pair<Word, double>;
+
+    static constexpr std::size_t max_cached_suggestions = 1 << 16;
+
+    // Unreadable files and lines are skipped, the cache only saves time. A file that contains lines of other contexts,
+    // repeated or unreadable lines is rewritten without them.
+    SuggestionCache(std::string path, std::string context) : path_{std::move(path)}, context_{std::move(context)} {
+        std::ifstream file{path_};
+        std::string line;
+        bool stale = false;
+
+        while (std::getline(file, line)) {
+            std::size_t const first = line.find('\t');
+            std::size_t const second = line.find('\t', first + 1);
+
+            if (second == std::string::npos || std::string_view{line}.substr(0, first) != context_) {
+                stale = true;
+                continue;
+            }
+
+            std::istringstream value{line.substr(second + 1)};
+            Suggestion suggestion;
+
+            try {
+                if (value >> suggestion.first >> suggestion.second && entries_.size() < max_cached_suggestions &&
+                    entries_.try_emplace(line.substr(first + 1, second - first - 1), suggestion).second) {
+                    continue;
+                }
+            } catch (std::invalid_argument const&) {
+            }
+
+            stale = true;
+        }
+
+        num_saved_ = entries_.size();
+
+        if (stale) {
+            file.close();
+            rewrite();
+        }
+    }
+
+    // The remaining words only depend on the set of turns, so the turns are sorted and deduplicated.
+    static std::string canonical_history(std::span<Turn const> const history) {
+        std::vector<Turn> turns{history.begin(), history.end()};
+        std::ranges::sort(turns);
+        auto const [first, last] = std::ranges::unique(turns);
+        turns.erase(first, last);
+
+        std::ostringstream result;
+
+        for (auto const& [guess, feedback] : turns) {
+            result << (result.tellp() > 0 ? " " : "") << guess << ':' << feedback_string(feedback);
+        }
+
+        return result.str();
+    }
+
+    std::optional<Suggestion> find(std::span<Turn const> const history) const {
+        auto const it = entries_.find(canonical_history(history));
+        return it == entries_.end() ? std::nullopt : std::optional{it->second};
+    }
+
+    // New entries are appended to the file right away, so nothing is lost when the program is interrupted.
+    void insert(std::span<Turn const> const history, Suggestion const& suggestion) {
+        std::string key = canonical_history(history);
+
+        if (!path_.empty() && num_saved_ < max_cached_suggestions && !entries_.contains(key)) {
+            std::ofstream file{path_, std::ios::app};
+            write_line(file, key, suggestion);
+            ++num_saved_;
+        }
+
+        entries_[std::move(key)] = suggestion;
+    }
+
+    // Adds an entry without writing it to the file, for suggestions that are stored elsewhere.
+    void remember(std::span<Turn const> const history, Suggestion const& suggestion) {
+        entries_[canonical_history(history)] = suggestion;
+    }
+
+    // Makes the suggestions of a second move table available, whether it applies has to be checked by the caller.
+    void remember(SecondMoveTable const& table) {
+        if (table.best_opener) {
+            remember({}, {table.opener, table.opener_score});
+        }
+
+        for (auto const& [feedback, suggestion] : table.replies) {
+            Turn const turn{table.opener, feedback};
+            remember({&turn, 1}, suggestion);
+        }
+    }
+
+    std::size_t size() const {
+        return entries_.size();
+    }
+
+private:
+    void write_line(std::ostream& out, std::string const& key, Suggestion const& suggestion) const {
+        out.precision(17);
+        out << context_ << '\t' << key << '\t' << suggestion.first << ' ' << suggestion.second << '\n';
+    }
+
+    // Replaces the file atomically by the entries loaded from it.
+    void rewrite() const {
+        if (path_.empty()) {
+            return;
+        }
+
+        std::string const temporary = path_ + ".tmp";
+
+        {
+            std::ofstream file{temporary};
+
+            for (auto const& [key, suggestion] : entries_) {
+                write_line(file, key, suggestion);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path_, error);
+
+        if (error) {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+
+    std::string path_;
+    std::string context_;
+    std::unordered_map<std::string, Suggestion> entries_;
+    std::size_t num_saved_ = 0;
+};
+
+// Concurrent trie of game states keyed by the sequence of (guess, response) turns. Every node stores its candidates
+// (and in hard mode the allowed guesses) as bitsets and computes its best guess at most once, so batch jobs over many
+// games with common prefixes handle each distinct state once. Nodes are created on demand by any number of threads.
+class StateTrie {
+public:
+    using Suggestion = std::pair<Word, double>;
+
+    struct Node {
+        WordSet candidates;
+        std::optional<WordSet> allowed;  // Only in hard mode, all guesses otherwise.
+        std::once_flag best_once;
+        Suggestion best;
+        std::mutex children_mut;
+        std::unordered_map<std::uint64_t, std::unique_ptr<Node>> children;
+    };
+
+    StateTrie(std::vector<Word> const& guesses, std::vector<Word> const& words,
+              std::unordered_map<Word, double> const& freqs, bool const hard_mode, Scoring const scoring)
+        : guesses_{&guesses}, words_{&words}, freqs_{&freqs}, hard_mode_{hard_mode}, scoring_{scoring} {
+        if (hard_mode_) {
+            packed_guesses_.emplace(guesses);
+        }
+
+        clear();
+    }
+
+    // Drops all nodes but the root. Must not run concurrently with anything else.
+    void clear() {
+        root_ = std::make_unique<Node>(WordSet{*words_});
+
+        if (hard_mode_) {
+            root_->allowed.emplace(*guesses_);
+        }
+
+        num_nodes_ = 1;
+        memory_usage_ = node_bytes(*root_);
+        transpositions_.clear();
+    }
+
+    Node& root() {
+        return *root_;
+    }
+
+    Node& child(Node& node, Word const guess, Feedback const feedback) {
+        std::uint64_t const key = (std::uint64_t{pack_word(guess)} << 8) | feedback;
+        std::lock_guard<std::mutex> guard(node.children_mut);
+        std::unique_ptr<Node>& result = node.children[key];
+
+        if (!result) {
+            result = std::make_unique<Node>(node.candidates);
+            result->candidates.for_each([&](std::size_t const i) {
+                if (feedback_code(guess, (*words_)[i]) != feedback) {
+                    result->candidates.erase(i);
+                }
+            });
+
+            if (hard_mode_) {
+                FilterMask const mask = filter_mask(*packed_guesses_, WordInfo{guess, feedback_string(feedback)});
+                result->allowed = node.allowed;
+                result->allowed->for_each([&](std::size_t const i) {
+                    if (!in_mask(mask, i)) {
+                        result->allowed->erase(i);
+                    }
+                });
+            }
+
+            ++num_nodes_;
+            memory_usage_ += node_bytes(*result) + sizeof(key) + 4 * sizeof(void*);
+        }
+
+        return *result;
+    }
+
+    std::vector<Word> candidates(Node const& node) const {
+        return select(node.candidates, *words_);
+    }
+
+    std::vector<Word> allowed(Node const& node) const {
+        return node.allowed ? select(*node.allowed, *guesses_) : *guesses_;
+    }
+
+    // Canonical hash of the state of a node: equal for all histories that leave the same candidates (and in hard mode
+    // the same allowed guesses).
+    static std::uint64_t state_hash(Node const& node) {
+        return node.candidates.hash() ^ (node.allowed ? mix64(node.allowed->hash() + 1) : 0);
+    }
+
+    // Best guess by best_choice, unless "lookup" (returning an optional suggestion) finds one elsewhere first or
+    // another node with the same state already has one. Threads asking for the same node wait for the first one
+    // instead of repeating its work. The search is isolated: while waiting in its parallel loop, the searching thread
+    // must not pick up another game that reaches this node and calls call_once on it again.
+    template <typename Fn>
+    Suggestion const& best(Node& node, Fn&& lookup) {
+        std::call_once(node.best_once, [&] { tbb::this_task_arena::isolate([&] { search(node, lookup); }); });
+
+        return node.best;
+    }
+
+    Suggestion const& best(Node& node) {
+        return best(node, [] { return std::optional<Suggestion>{}; });
+    }
+
+    std::size_t num_nodes() const {
+        return num_nodes_;
+    }
+
+    // Approximate number of bytes held by the nodes, including the bitsets and the hash maps linking them.
+    std::size_t memory_usage() const {
+        return memory_usage_;
+    }
+
+    // Number of best_choice searches run so far.
+    std::size_t num_searches() const {
+        return num_searches_;
+    }
+
+    // Number of best guesses taken from a node with the same state that was reached through other guesses.
+    std::size_t num_transpositions() const {
+        return num_transpositions_;
+    }
+
+private:
+    template <typename Fn>
+    void search(Node& node, Fn const& lookup) {
+        if (std::optional<Suggestion> const found = std::invoke(lookup)) {
+            node.best = *found;
+        } else if (node.candidates.size() == 1) {
+            // What best_choice would return as well: every guess scores 0 and the candidate wins the tiebreak.
+            node.best = {candidates(node).front(), 0.0};
+        } else if (std::optional<Suggestion> const known = transposition(node)) {
+            node.best = *known;
+            ++num_transpositions_;
+        } else {
+            node.best = best_choice(allowed(node), candidates(node), *freqs_, scoring_);
+            ++num_searches_;
+
+            std::unique_lock<std::shared_mutex> lock(transpositions_mut_);
+            transpositions_.try_emplace(state_hash(node), node.best, node.candidates.size());
+        }
+    }
+
+    // Best guess of an earlier node with the same state. The size guards against the unlikely hash collisions of
+    // different sets.
+    std::optional<Suggestion> transposition(Node const& node) const {
+        std::shared_lock<std::shared_mutex> lock(transpositions_mut_);
+        auto const it = transpositions_.find(state_hash(node));
+
+        if (it == transpositions_.end() || it->second.second != node.candidates.size()) {
+            return std::nullopt;
+        }
+
+        return it->second.first;
+    }
+
+    static std::vector<Word> select(WordSet const& set, std::vector<Word> const& list) {
+        std::vector<Word> result;
+        result.reserve(set.size());
+        set.for_each([&](std::size_t const i) { result.push_back(list[i]); });
+        return result;
+    }
+
+    static std::size_t node_bytes(Node const& node) {
+        return sizeof(Node) + node.candidates.blocks().size_bytes() +
+               (node.allowed ? node.allowed->blocks().size_bytes() : 0);
+    }
+
+    std::vector<Word> const* guesses_;
+    std::vector<Word> const* words_;
+    std::unordered_map<Word, double> const* freqs_;
+    bool hard_mode_;
+    Scoring scoring_;
+    std::optional<PackedWords> packed_guesses_;  // Only in hard mode.
+    std::unique_ptr<Node> root_;
+    std::atomic<std::size_t> num_nodes_ = 0;
+    std::atomic<std::size_t> memory_usage_ = 0;
+    std::atomic<std::size_t> num_searches_ = 0;
+    std::atomic<std::size_t> num_transpositions_ = 0;
+    mutable std::shared_mutex transpositions_mut_;
+    std::unordered_map<std::uint64_t, std::pair<Suggestion, std::size_t>> transpositions_;
+};
+
+// Recorded game as alternating guesses and responses separated by whitespace. Responses may be upper case and a number
+// directly after the last one is ignored, so lines of the text strategy format ("soare BBBBB clint BBBBB pudgy
+// GGGGG3") are recorded games as well.
+inline std::vector<SuggestionCache::Turn> parse_recorded_game(std::string const& line) {
+    std::istringstream tokens{line};
+    std::vector<SuggestionCache::Turn> result;
+    Word guess;
+    std::string response;
+
+    while (tokens >> guess) {
+        if (!(tokens >> response) || response.size() < 5) {
+            throw std::invalid_argument("Expected a response after every guess!");
+        }
+
+        result.emplace_back(guess, parse_feedback(response.substr(0, 5)));
+    }
+
+    return result;
+}
+
+// Metrics of one move of a recorded game. Information is measured in bits: the expected information of a guess is the
+// entropy of the candidates minus the average entropy after it, the actual information is log_2 of the factor by which
+// the response reduced the candidates.
+struct MoveMetrics {
+    Word guess;
+    Feedback feedback;
+    std::size_t candidates;
+    std::size_t remaining;
+    Word best_guess;
+    double chosen_bits;
+    double best_bits;
+    double actual_bits;
+
+    // Fraction of the achievable expected information that the guess got.
+    double skill() const {
+        return best_bits > 0.0 ? chosen_bits / best_bits : 1.0;
+    }
+
+    // Information beyond what the guess could be expected to give.
+    double luck() const {
+        return actual_bits - chosen_bits;
+    }
+};
+
+// Replays recorded games against the word lists, walking a StateTrie so that candidates and best guesses (by average
+// entropy) are shared between all games. Best guesses are looked up in a read only cache such as the one of the
+// interactive loop before they are computed. Replaying is thread safe, clearing the trie to bound memory is not.
+class GameReplayer {
+public:
+    GameReplayer(std::vector<Word> const& guesses, std::vector<Word> const& words, bool const hard_mode,
+                 SuggestionCache const* const shared = nullptr)
+        : trie_{guesses, words, no_freqs_, hard_mode, Scoring::entropy}, shared_{shared} {}
+
+    // Metrics for every move up to the one that solved the game, or up to the first response that is inconsistent with
+    // the word list.
+    std::vector<MoveMetrics> replay(std::span<SuggestionCache::Turn const> const game) {
+        std::vector<MoveMetrics> result;
+        StateTrie::Node* node = &trie_.root();
+        std::vector<Word> candidates = trie_.candidates(*node);
+
+        for (std::size_t t = 0; t < game.size() && !candidates.empty(); ++t) {
+            auto const [guess, feedback] = game[t];
+            double const bits = std::log2(candidates.size());
+
+            ++lookups_;
+            auto const [best, best_score] = trie_.best(*node, [&] {
+                return shared_ ? shared_->find(game.first(t)) : std::nullopt;
+            });
+
+            MoveMetrics& move = result.emplace_back();
+            move.guess = guess;
+            move.feedback = feedback;
+            move.candidates = candidates.size();
+            move.best_guess = best;
+            move.chosen_bits = bits - EntropyObjective{}(feedback_histogram(guess, candidates), candidates.size());
+            move.best_bits = bits - best_score;
+
+            node = &trie_.child(*node, guess, feedback);
+            candidates = trie_.candidates(*node);
+            move.remaining = candidates.size();
+            move.actual_bits = candidates.empty() ? 0.0 : bits - std::log2(candidates.size());
+
+            if (feedback == all_green) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    StateTrie& trie() {
+        return trie_;
+    }
+
+    std::size_t cache_hits() const {
+        return lookups_ - trie_.num_searches();
+    }
+
+    std::size_t cache_misses() const {
+        return trie_.num_searches();
+    }
+
+private:
+    std::unordered_map<Word, double> no_freqs_;
+    StateTrie trie_;
+    SuggestionCache const* shared_;
+    std::atomic<std::size_t> lookups_ = 0;
+};
+
+// Child process running a shell command, whose standard input and output are connected to one end of a Unix socket
+// pair. Messages are single lines; the command may just as well run the worker on another machine (e.g. over ssh). The
+// command runs in its own process group, so that a worker that stopped answering can be killed with all its children.
+class WorkerProcess {
+public:
+    explicit WorkerProcess(std::string const& command) {
+        int fds[2];
+
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            throw std::runtime_error("Could not create a socket pair for a worker!");
+        }
+
+        pid_ = ::fork();
+
+        if (pid_ == 0) {
+            ::setpgid(0, 0);
+            ::dup2(fds[1], STDIN_FILENO);
+            ::dup2(fds[1], STDOUT_FILENO);
+            ::execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+            ::_exit(127);
+        }
+
+        ::close(fds[1]);
+        fd_ = fds[0];
+
+        if (pid_ < 0) {
+            ::close(fd_);
+            throw std::runtime_error("Could not start worker \"" + command + "\"!");
+        }
+
+        ::setpgid(pid_, pid_);
+    }
+
+    WorkerProcess(WorkerProcess const&) = delete;
+    WorkerProcess& operator=(WorkerProcess const&) = delete;
+
+    // Closing the input tells the worker to exit, it is killed if it does not do so within a second.
+    ~WorkerProcess() {
+        ::shutdown(fd_, SHUT_WR);
+        ::close(fd_);
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+
+        while (::waitpid(pid_, nullptr, WNOHANG) == 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                ::kill(-pid_, SIGKILL);
+                ::waitpid(pid_, nullptr, 0);
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    // Sends a line and waits for the reply line, nothing if the worker died, closed its output or did not answer within
+    // "timeout". A worker that timed out is killed.
+    std::optional<std::string> request(std::string line, std::chrono::milliseconds const timeout) {
+        auto const deadline = std::chrono::steady_clock::now() + timeout;
+        line += '\n';
+
+        for (std::size_t sent = 0; sent < line.size();) {
+            if (!wait(POLLOUT, deadline)) {
+                return std::nullopt;
+            }
+
+            ssize_t const n = ::send(fd_, line.data() + sent, line.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+            if (n <= 0) {
+                return std::nullopt;
+            }
+
+            sent += n;
+        }
+
+        std::size_t end;
+
+        while ((end = buffer_.find('\n')) == std::string::npos) {
+            if (!wait(POLLIN, deadline)) {
+                return std::nullopt;
+            }
+
+            char chunk[4096];
+            ssize_t const n = ::recv(fd_, chunk, sizeof(chunk), MSG_DONTWAIT);
+
+            if (n <= 0) {
+                return std::nullopt;
+            }
+
+            buffer_.append(chunk, n);
+        }
+
+        std::string reply = buffer_.substr(0, end);
+        buffer_.erase(0, end + 1);
+        return reply;
+    }
+
+private:
+    // Whether the socket became ready for "events" (or was closed) before the deadline, kills the worker if not.
+    bool wait(short const events, std::chrono::steady_clock::time_point const deadline) {
+        while (true) {
+            auto const left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            int const ms = static_cast<int>(std::clamp<std::int64_t>(left.count(), 0, std::numeric_limits<int>::max()));
+            pollfd pfd{fd_, events, 0};
+            int const n = ms > 0 ? ::poll(&pfd, 1, ms) : 0;
+
+            if (n > 0) {
+                return true;
+            }
+
+            if (n == 0) {
+                ::kill(-pid_, SIGKILL);
+                return false;
+            }
+
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    pid_t pid_;
+    int fd_;
+    std::string buffer_;
+};
+
+// Runs tasks of one line each on worker processes, with one thread per worker that hands it the next task as soon as it
+// answered the previous one. A worker that dies or answers with an empty line is restarted and its task goes back to
+// the queue; after "max_failures" failures in a row the worker is dropped. A worker that does not answer a task within
+// "timeout" counts as failed as well. Workers are kept between runs.
+class WorkerPool {
+public:
+    explicit WorkerPool(std::vector<std::string> commands, std::size_t const max_failures = 3,
+                        std::chrono::milliseconds const timeout = std::chrono::minutes{10})
+        : commands_{std::move(commands)}, workers_(commands_.size()), alive_(commands_.size(), true),
+          failures_(commands_.size(), 0), max_failures_{max_failures}, timeout_{timeout} {}
+
+    // Replies to the tasks in the same order. Throws if tasks are left when all workers are dropped.
+    std::vector<std::string> run(std::vector<std::string> const& tasks) {
+        std::vector<std::string> result(tasks.size());
+        std::vector<std::size_t> queue(tasks.size());
+        std::iota(queue.rbegin(), queue.rend(), 0);
+        std::mutex queue_mut;
+        std::vector<std::thread> threads;
+
+        auto const work = [&](std::size_t const w) {
+            while (true) {
+                std::size_t task;
+
+                {
+                    std::lock_guard<std::mutex> guard(queue_mut);
+
+                    if (queue.empty()) {
+                        return;
+                    }
+
+                    task = queue.back();
+                    queue.pop_back();
+                }
+
+                std::optional<std::string> reply;
+
+                try {
+                    if (!workers_[w]) {
+                        workers_[w] = std::make_unique<WorkerProcess>(commands_[w]);
+                    }
+
+                    reply = workers_[w]->request(tasks[task], timeout_);
+                } catch (std::runtime_error const&) {
+                }
+
+                if (reply && !reply->empty()) {
+                    result[task] = std::move(*reply);
+                    failures_[w] = 0;
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> guard(queue_mut);
+                queue.push_back(task);
+                workers_[w].reset();
+                ++num_failures_;
+
+                if (++failures_[w] >= max_failures_) {
+                    alive_[w] = false;
+                    return;
+                }
+            }
+        };
+
+        // Tasks given back by a dropped worker after the others ran out of work need another round.
+        while (!queue.empty()) {
+            for (std::size_t w = 0; w < commands_.size(); ++w) {
+                if (alive_[w]) {
+                    threads.emplace_back(work, w);
+                }
+            }
+
+            if (threads.empty()) {
+                throw std::runtime_error("All workers failed!");
+            }
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            threads.clear();
+        }
+
+        return result;
+    }
+
+    std::size_t num_workers() const {
+        return std::ranges::count(alive_, true);
+    }
+
+    // Number of tasks that had to be retried.
+    std::size_t num_failures() const {
+        return num_failures_;
+    }
+
+private:
+    std::vector<std::string> commands_;
+    std::vector<std::unique_ptr<WorkerProcess>> workers_;
+    std::vector<char> alive_;  // Not vector<bool>, the worker threads update their entries concurrently.
+    std::vector<std::size_t> failures_;  // Failures in a row of every worker, also across runs.
+    std::size_t max_failures_;
+    std::chrono::milliseconds timeout_;
+    std::atomic<std::size_t> num_failures_ = 0;
+};
+
+// Guesses and words left after the turns of a game.
+inline std::pair<std::vector<Word>, std::vector<Word>> narrow_down(std::span<SuggestionCache::Turn const> const history,
+                                                                   std::vector<Word> guesses, std::vector<Word> words,
+                                                                   bool const hard_mode) {
+    for (auto const& [guess, feedback] : history) {
+        WordInfo const info{guess, feedback_string(feedback)};
+        words = filter_words(words, info);
+
+        if (hard_mode) {
+            guesses = filter_words(guesses, info);
+        }
+    }
+
+    return {std::move(guesses), std::move(words)};
+}
+
+// Task of a lookahead worker: the guess to evaluate, the cost above which it may be given up and the turns so far,
+// e.g. "clint 3.5 soare bbybb". The reply is the guess and its expected cost, or some cost of at least the cutoff.
+inline std::string lookahead_task(std::span<SuggestionCache::Turn const> const history, Word const guess,
+                                  double const cutoff) {
+    std::ostringstream task;
+    task.precision(17);
+    task << guess << ' ' << cutoff;
+
+    for (auto const& [g, feedback] : history) {
+        task << ' ' << g << ' ' << feedback_string(feedback);
+    }
+
+    return task.str();
+}
+
+// Answers a lookahead task like best_choice_lookahead would evaluate the guess, or with an empty line if the task is
+// invalid.
+inline std::string serve_lookahead_task(std::string const& task, std::vector<Word> const& guess_list,
+                                        std::vector<Word> const& word_list, CostModel const& model,
+                                        bool const hard_mode, std::size_t const depth, std::size_t const width,
+                                        TranspositionTable& table) {
+    std::istringstream tokens{task};
+    std::string rest;
+    Word guess;
+    double cutoff;
+
+    if (!(tokens >> guess >> cutoff)) {
+        return "";
+    }
+
+    std::getline(tokens, rest);
+    std::vector<SuggestionCache::Turn> history;
+
+    try {
+        history = parse_recorded_game(rest);
+    } catch (std::invalid_argument const&) {
+        return "";
+    }
+
+    auto const [guesses, words] = narrow_down(history, guess_list, word_list, hard_mode);
+
+    if (words.size() <= 2 || depth <= 1) {
+        return "";
+    }
+
+    double const cost = lookahead_guess_cost(guesses, words, guess, model, hard_mode, depth, width, table,
+                                             lookahead_parallel_words, [&] { return cutoff; });
+    std::ostringstream reply;
+    reply.precision(17);
+    reply << guess << ' ' << cost;
+    return reply.str();
+}
+
+// best_choice_lookahead with the candidate guesses of the root evaluated by the workers, which have to run
+// serve_lookahead_task with the same lists and settings. Like the local search, the most promising guess is evaluated
+// first and its cost is the cutoff for the others, which can then be given up early. Gives the same result as the
+// local search.
+inline std::pair<Word, double> distributed_lookahead(WorkerPool& pool,
+                                                     std::span<SuggestionCache::Turn const> const history,
+                                                     std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                                     CostModel const& model, bool const hard_mode,
+                                                     std::size_t const depth, std::size_t const width) {
+    if (words.size() <= 2 || depth <= 1) {
+        return best_choice_lookahead(guesses, words, model, hard_mode, depth, width);
+    }
+
+    std::vector<std::pair<double, Word>> const ranked = lookahead_candidates(guesses, words, model, width);
+    std::pair<Word, double> best{ranked.front().second, std::numeric_limits<double>::max()};
+
+    auto const evaluate = [&](std::span<std::pair<double, Word> const> const candidates) {
+        std::vector<std::string> tasks;
+
+        for (auto const& [estimate, guess] : candidates) {
+            tasks.push_back(lookahead_task(history, guess, best.second));
+        }
+
+        std::vector<std::string> const replies = pool.run(tasks);
+
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            std::istringstream reply{replies[i]};
+            Word guess;
+            double cost;
+
+            if (!(reply >> guess >> cost) || guess != candidates[i].second) {
+                throw std::runtime_error("Unexpected reply \"" + replies[i] + "\" from a worker!");
+            }
+
+            if (cost < best.second) {
+                best = {guess, cost};
+            }
+        }
+    };
+
+    evaluate(std::span{ranked}.first(1));
+    evaluate(std::span{ranked}.subspan(1));
+    return best;
+}
+
+// Fingerprint of the lists and settings of a lookahead search, which its checkpoints only apply to.
+inline std::uint64_t lookahead_fingerprint(std::vector<Word> const& guesses, std::vector<Word> const& words,
+                                           CostModel const& model, bool const hard_mode, std::size_t const depth,
+                                           std::size_t const width) {
+    std::uint64_t result = mix64(search_fingerprint(guesses, words) ^ hard_mode);
+    result = mix64(result ^ depth);
+    result = mix64(result ^ width);
+
+    for (double const c : model.coeffs) {
+        result = mix64(result ^ std::bit_cast<std::uint64_t>(c));
+    }
+
+    return result;
+}
+
+constexpr std::uint32_t checkpoint_tag = 0x54504b43;        // "CKPT"
+constexpr std::uint32_t finished_guesses_tag = 0x4e494647;  // "GFIN"
+constexpr std::uint32_t finished_buckets_tag = 0x4e494642;  // "BFIN"
+constexpr std::uint32_t table_entries_tag = 0x53424154;     // "TABS"
+
+// Progress of a long lookahead search that survives the process: the costs of the root guesses searched so far, the
+// costs of the buckets of their first responses searched so far and a snapshot of the transposition table. Once
+// started, a background thread writes them every "interval" (and once more when the checkpoint is destroyed), so the
+// search threads never wait for the disk. Files are replaced atomically, so a killed job leaves the previous checkpoint
+// intact. checkpointed_lookahead starts the writer, after any resume: a writer started before could replace the
+// previous checkpoint with a partially loaded one.
+//
+// File layout: a data file (see load_data_file) with the sections CKPT (fingerprint, u64), GFIN (per finished guess
+// the state key (u64), packed guess (u32) and cost (f64)), BFIN (per finished bucket its state key (u64) and cost
+// (f64)) and TABS (per table entry the key (u64), packed best guess (u32), depth (u8) and score (f64)).
+class SearchCheckpoint {
+public:
+    SearchCheckpoint(std::string path, std::uint64_t const fingerprint, TranspositionTable& table,
+                     std::chrono::milliseconds const interval)
+        : path_{std::move(path)}, fingerprint_{fingerprint}, table_{&table}, interval_{interval} {}
+
+    SearchCheckpoint(SearchCheckpoint const&) = delete;
+    SearchCheckpoint& operator=(SearchCheckpoint const&) = delete;
+
+    // Nothing is written if the writer was never started.
+    ~SearchCheckpoint() {
+        if (!writer_.joinable()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(stop_mut_);
+            stop_ = true;
+        }
+
+        stop_cv_.notify_all();
+        writer_.join();
+        write();
+    }
+
+    // Starts the background writer, does nothing if it is running already.
+    void start() {
+        if (writer_.joinable()) {
+            return;
+        }
+
+        writer_ = std::thread([this] {
+            std::unique_lock<std::mutex> lock(stop_mut_);
+
+            while (!stop_cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+                lock.unlock();
+                write();
+                lock.lock();
+            }
+        });
+    }
+
+    // Loads the checkpoint file into this checkpoint and the table if it exists and was written for the same
+    // fingerprint, and returns whether it did.
+    bool resume() {
+        if (!std::filesystem::exists(path_)) {
+            return false;
+        }
+
+        DataSections const sections = load_data_file(path_);
+        auto const header = sections.find(checkpoint_tag);
+        std::uint64_t fingerprint = 0;
+
+        if (header == sections.end() || header->second.size() != sizeof(fingerprint)) {
+            throw std::runtime_error("Invalid checkpoint " + path_ + "!");
+        }
+
+        std::memcpy(&fingerprint, header->second.data(), sizeof(fingerprint));
+
+        if (fingerprint != fingerprint_) {
+            return false;
+        }
+
+        auto const records = [&](std::uint32_t const tag) {
+            auto const it = sections.find(tag);
+            return it == sections.end() ? std::span<char const>{} : std::span<char const>{it->second};
+        };
+
+        std::span<char const> data;
+
+        auto const read = [&]<typename T>(T& value) {
+            if (data.size() < sizeof(T)) {
+                throw std::runtime_error("Invalid checkpoint " + path_ + "!");
+            }
+
+            std::memcpy(&value, data.data(), sizeof(T));
+            data = data.subspan(sizeof(T));
+        };
+
+        std::lock_guard<std::mutex> guard(finished_mut_);
+
+        for (data = records(finished_guesses_tag); !data.empty();) {
+            std::uint64_t state = 0;
+            std::uint32_t guess = 0;
+            double cost = 0.0;
+            read(state);
+            read(guess);
+            read(cost);
+            finished_[{state, guess}] = cost;
+        }
+
+        for (data = records(finished_buckets_tag); !data.empty();) {
+            std::uint64_t state = 0;
+            double cost = 0.0;
+            read(state);
+            read(cost);
+            finished_buckets_[state] = cost;
+        }
+
+        for (data = records(table_entries_tag); !data.empty();) {
+            std::uint64_t key = 0;
+            std::uint32_t best = 0;
+            TranspositionTable::Entry entry;
+            read(key);
+            read(best);
+            read(entry.depth);
+            read(entry.score);
+            entry.best = unpack_word(best);
+            table_->store(key, entry);
+        }
+
+        return true;
+    }
+
+    void record(std::uint64_t const state, Word const guess, double const cost) {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        finished_[{state, pack_word(guess)}] = cost;
+    }
+
+    std::optional<double> find(std::uint64_t const state, Word const guess) const {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        auto const it = finished_.find({state, pack_word(guess)});
+        return it == finished_.end() ? std::nullopt : std::optional{it->second};
+    }
+
+    std::size_t num_finished() const {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        return finished_.size();
+    }
+
+    // Buckets are identified by the state key of their search, so a bucket reached through another guess is found as
+    // well.
+    void record_bucket(std::uint64_t const state, double const cost) {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        finished_buckets_[state] = cost;
+    }
+
+    std::optional<double> find_bucket(std::uint64_t const state) const {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        auto const it = finished_buckets_.find(state);
+        return it == finished_buckets_.end() ? std::nullopt : std::optional{it->second};
+    }
+
+    std::size_t num_finished_buckets() const {
+        std::lock_guard<std::mutex> guard(finished_mut_);
+        return finished_buckets_.size();
+    }
+
+    // Writes the checkpoint now. Errors are not thrown (the writer thread could not handle them) but kept for
+    // last_error.
+    void write() {
+        std::lock_guard<std::mutex> write_guard(write_mut_);
+        DataSections sections;
+
+        auto const writer = [&](std::uint32_t const tag) {
+            return [&data = sections[tag]](auto const value) {
+                auto const* bytes = reinterpret_cast<char const*>(&value);
+                data.insert(data.end(), bytes, bytes + sizeof(value));
+            };
+        };
+
+        writer(checkpoint_tag)(fingerprint_);
+
+        {
+            auto const write_finished = writer(finished_guesses_tag);
+            std::lock_guard<std::mutex> guard(finished_mut_);
+
+            for (auto const& [key, cost] : finished_) {
+                write_finished(key.first);
+                write_finished(key.second);
+                write_finished(cost);
+            }
+
+            auto const write_bucket = writer(finished_buckets_tag);
+
+            for (auto const& [state, cost] : finished_buckets_) {
+                write_bucket(state);
+                write_bucket(cost);
+            }
+        }
+
+        auto const write_entry = writer(table_entries_tag);
+
+        for (auto const& [key, entry] : table_->entries()) {
+            write_entry(key);
+            write_entry(pack_word(entry.best));
+            write_entry(entry.depth);
+            write_entry(entry.score);
+        }
+
+        std::string const temporary = path_ + ".tmp";
+
+        try {
+            save_data_file(sections, temporary);
+            std::filesystem::rename(temporary, path_);
+            ++num_writes_;
+        } catch (std::exception const& e) {
+            last_error_ = e.what();
+        }
+    }
+
+    std::size_t num_writes() const {
+        return num_writes_;
+    }
+
+    std::string last_error() const {
+        std::lock_guard<std::mutex> write_guard(write_mut_);
+        return last_error_;
+    }
+
+private:
+    std::string path_;
+    std::uint64_t fingerprint_;
+    TranspositionTable* table_;
+    std::chrono::milliseconds interval_;
+    mutable std::mutex finished_mut_;
+    std::map<std::pair<std::uint64_t, std::uint32_t>, double> finished_;
+    std::map<std::uint64_t, double> finished_buckets_;
+    mutable std::mutex write_mut_;
+    std::atomic<std::size_t> num_writes_ = 0;
+    std::string last_error_;
+    std::mutex stop_mut_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+    std::thread writer_;
+};
+
+// best_choice_lookahead for long searches: the root guesses are searched like there (the most promising first, then the
+// others in parallel against the best cost so far) and recorded in the checkpoint together with the buckets of their
+// first responses, so that a resumed search skips the guesses and buckets that are finished. Costs of guesses that are
+// given up are recorded as well, they can only be compared with a guess that is recorded before. Gives the same result
+// as best_choice_lookahead.
+inline std::pair<Word, double> checkpointed_lookahead(SearchCheckpoint& checkpoint, std::vector<Word> const& guesses,
+                                                      std::vector<Word> const& words, CostModel const& model,
+                                                      bool const hard_mode, std::size_t const depth,
+                                                      std::size_t const width, TranspositionTable& table) {
+    checkpoint.start();
+
+    if (words.size() <= 2 || depth <= 1) {
+        return best_choice_lookahead(guesses, words, model, hard_mode, depth, width, table);
+    }
+
+    std::uint64_t const state = lookahead_key(guesses, words, hard_mode, depth);
+    std::vector<std::pair<double, Word>> const ranked = lookahead_candidates(guesses, words, model, width);
+
+    auto const search_bucket = [&](std::vector<Word> const& bucket_guesses, std::vector<Word> const& bucket) {
+        std::uint64_t const bucket_state = lookahead_key(bucket_guesses, bucket, hard_mode, depth - 1);
+
+        if (std::optional<double> const cost = checkpoint.find_bucket(bucket_state)) {
+            return *cost;
+        }
+
+        double const cost = best_choice_lookahead(bucket_guesses, bucket, model, hard_mode, depth - 1, width, table,
+                                                  lookahead_parallel_words)
+                                .second;
+        checkpoint.record_bucket(bucket_state, cost);
+        return cost;
+    };
+
+    return young_brothers_wait(ranked, [&](Word const guess, auto const& cutoff) {
+        if (std::optional<double> const value = checkpoint.find(state, guess)) {
+            return *value;
+        }
+
+        double const value =
+            lookahead_guess_cost(guesses, words, guess, hard_mode, lookahead_parallel_words, cutoff, search_bucket);
+        checkpoint.record(state, guess, value);
+        return value;
+    });
+}
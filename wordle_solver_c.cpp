@@ -0,0 +1,178 @@
+#include "wordle_solver_c.h"
+
+#include "wordle_solver.hpp"
+
+#include <exception>
+#include <string>
+#include <vector>
+
+struct wordle_solver {
+    Dictionary dict;
+    MultiGame game;
+    std::string word_table;
+
+    wordle_solver(char const* guess_list_path, char const* word_list_path, std::size_t const num_boards)
+        : dict{load_word_list(guess_list_path), load_word_list(word_list_path)}, game{dict, num_boards} {
+        std::ostringstream os;
+
+        for (Word const& w : dict.words) {
+            os << w;
+        }
+
+        word_table = os.str();
+    }
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+// Runs fn and turns exceptions into error codes, since they must not cross the C boundary.
+template <typename Fn>
+int guarded(Fn&& fn) {
+    try {
+        last_error.clear();
+        std::invoke(fn);
+        return 0;
+    } catch (std::exception const& e) {
+        last_error = e.what();
+    } catch (...) {
+        last_error = "Unknown error!";
+    }
+
+    return -1;
+}
+
+// Throws if any of the pointers is null, the message names the function.
+template <typename... Ts>
+void require(char const* function, Ts const*... pointers) {
+    if (((pointers == nullptr) || ...)) {
+        throw std::invalid_argument(std::string{"Invalid arguments to "} + function + "!");
+    }
+}
+
+}  // namespace
+
+extern "C" {
+
+int wordle_solver_abi_version(void) {
+    return WORDLE_SOLVER_ABI_VERSION;
+}
+
+wordle_solver* wordle_solver_create(char const* guess_list_path, char const* word_list_path, size_t num_boards) {
+    wordle_solver* result = nullptr;
+
+    guarded([&] {
+        if (guess_list_path == nullptr || word_list_path == nullptr || num_boards == 0) {
+            throw std::invalid_argument("Invalid arguments to wordle_solver_create!");
+        }
+
+        result = new wordle_solver{guess_list_path, word_list_path, num_boards};
+
+        if (result->dict.guesses.empty() || result->dict.words.empty()) {
+            delete result;
+            result = nullptr;
+            throw std::runtime_error("Could not load word lists!");
+        }
+    });
+
+    return result;
+}
+
+void wordle_solver_free(wordle_solver* solver) {
+    delete solver;
+}
+
+int wordle_solver_load_data(wordle_solver* solver, char const* data_path) {
+    return guarded([&] {
+        require("wordle_solver_load_data", solver, data_path);
+        solver->dict.second_moves = load_second_moves(load_data_file(data_path));
+    });
+}
+
+char const* wordle_solver_last_error(void) {
+    return last_error.c_str();
+}
+
+int wordle_solver_suggest(wordle_solver* solver, char guess[6], double* score) {
+    return guarded([&] {
+        require("wordle_solver_suggest", solver, guess);
+        auto const [word, s] = solver->game.suggest();
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            guess[i] = static_cast<char>(word[i] + 'a');
+        }
+
+        guess[5] = '\0';
+
+        if (score != nullptr) {
+            *score = s;
+        }
+    });
+}
+
+int wordle_solver_apply_feedback(wordle_solver* solver, char const* guess, uint8_t const* feedback) {
+    return guarded([&] {
+        require("wordle_solver_apply_feedback", solver, guess, feedback);
+
+        if (std::ranges::any_of(std::span{feedback, solver->game.num_boards()},
+                                [](uint8_t const f) { return f >= num_feedbacks; })) {
+            throw std::invalid_argument("Invalid feedback code!");
+        }
+
+        solver->game.apply_feedback(parse_word(guess), std::span{feedback, solver->game.num_boards()});
+    });
+}
+
+int wordle_solver_parse_feedback(char const* response, uint8_t* code) {
+    return guarded([&] {
+        require("wordle_solver_parse_feedback", response, code);
+        *code = parse_feedback(response);
+    });
+}
+
+size_t wordle_solver_num_boards(wordle_solver const* solver) {
+    return solver == nullptr ? 0 : solver->game.num_boards();
+}
+
+int wordle_solver_solved(wordle_solver const* solver, size_t board) {
+    bool solved = false;
+    int const result = guarded([&] {
+        require("wordle_solver_solved", solver);
+
+        if (board >= solver->game.num_boards()) {
+            throw std::out_of_range("Invalid board!");
+        }
+
+        solved = solver->game.solved(board);
+    });
+
+    return result < 0 ? result : solved;
+}
+
+char const* wordle_solver_words(wordle_solver const* solver, size_t* count) {
+    char const* result = nullptr;
+
+    guarded([&] {
+        require("wordle_solver_words", solver, count);
+        *count = solver->dict.words.size();
+        result = solver->word_table.data();
+    });
+
+    return result;
+}
+
+int wordle_solver_candidates(wordle_solver const* solver, size_t board, uint64_t const** blocks, size_t* num_blocks) {
+    return guarded([&] {
+        require("wordle_solver_candidates", solver, blocks, num_blocks);
+
+        if (board >= solver->game.num_boards()) {
+            throw std::out_of_range("Invalid board!");
+        }
+
+        std::span<std::uint64_t const> const bits = solver->game.candidates(board).blocks();
+        *blocks = bits.data();
+        *num_blocks = bits.size();
+    });
+}
+}
@@ -0,0 +1,73 @@
+/* Stable C interface to the solver for use from other languages. All functions that can fail return 0 on success and
+ * a negative value on failure, in which case wordle_solver_last_error describes the problem. A NULL solver or output
+ * pointer is such a failure; wordle_solver_num_boards returns 0 and wordle_solver_words NULL for a NULL solver. */
+#ifndef WORDLE_SOLVER_C_H
+#define WORDLE_SOLVER_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef WORDLE_SOLVER_BUILDING_C_API
+#define WORDLE_SOLVER_API __attribute__((visibility("default")))
+#else
+#define WORDLE_SOLVER_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version of this interface, increased with every incompatible change and used as the SONAME version of the library.
+ * A program can compare wordle_solver_abi_version with the version it was compiled against. */
+#define WORDLE_SOLVER_ABI_VERSION 1
+
+typedef struct wordle_solver wordle_solver;
+
+WORDLE_SOLVER_API int wordle_solver_abi_version(void);
+
+/* Loads the guess and word lists and starts a game with the given number of boards (1 for Wordle, 4 for Quordle).
+ * Returns NULL on failure. */
+WORDLE_SOLVER_API wordle_solver* wordle_solver_create(char const* guess_list_path, char const* word_list_path,
+                                                      size_t num_boards);
+
+WORDLE_SOLVER_API void wordle_solver_free(wordle_solver* solver);
+
+/* Loads the precomputed second guesses from a data file written by "wordle_solver second", after which the first two
+ * suggestions of a single board game in normal mode need no search. Tables for other word lists are ignored. */
+WORDLE_SOLVER_API int wordle_solver_load_data(wordle_solver* solver, char const* data_path);
+
+/* Message for the last error on the calling thread, or an empty string. */
+WORDLE_SOLVER_API char const* wordle_solver_last_error(void);
+
+/* Writes the suggested guess as 5 lowercase letters followed by a null terminator and its score (smaller is
+ * better) if "score" is not NULL. */
+WORDLE_SOLVER_API int wordle_solver_suggest(wordle_solver* solver, char guess[6], double* score);
+
+/* Applies the responses of all boards to "guess" (5 lowercase letters). "feedback" holds one code per board with one
+ * base 3 digit per letter (0 = gray, 1 = yellow, 2 = green), first letter least significant. Responses for solved
+ * boards are ignored. */
+WORDLE_SOLVER_API int wordle_solver_apply_feedback(wordle_solver* solver, char const* guess, uint8_t const* feedback);
+
+/* Converts a response like "bygbb" to its code. */
+WORDLE_SOLVER_API int wordle_solver_parse_feedback(char const* response, uint8_t* code);
+
+WORDLE_SOLVER_API size_t wordle_solver_num_boards(wordle_solver const* solver);
+
+/* Returns 1 if the board is solved, 0 if not and a negative value if there is no such board. */
+WORDLE_SOLVER_API int wordle_solver_solved(wordle_solver const* solver, size_t board);
+
+/* All possible secret words as one array of 5 * count lowercase letters without separators. The pointer stays valid
+ * until the solver is freed. */
+WORDLE_SOLVER_API char const* wordle_solver_words(wordle_solver const* solver, size_t* count);
+
+/* Zero-copy access to the remaining words of a board as a bitset over the indices of wordle_solver_words: word i
+ * remains if bit i % 64 of (*blocks)[i / 64] is set. The pointer stays valid until the next call that modifies the
+ * solver. */
+WORDLE_SOLVER_API int wordle_solver_candidates(wordle_solver const* solver, size_t board, uint64_t const** blocks,
+                                               size_t* num_blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif